@@ -174,11 +174,17 @@ enum ListCategory
 enum ValueFlags
 {
   VF_NONE     = 0x0000,   ///< no flags
+  VF_chars    = 0x0080,   ///< typed ravel: Unicode[]     (not Cell[])
+  VF_ints     = 0x0100,   ///< typed ravel: APL_Integer[] (not Cell[])
+  VF_floats   = 0x0200,   ///< typed ravel: APL_Float[]   (not Cell[])
   VF_complete = 0x0400,   ///< CHECK called
   VF_marked   = 0x0800,   ///< marked to detect stale
-  VF_temp     = 0x1000,   ///< computed value
+  VF_temp     = 0x1000,   ///< computed value, held only by a prefix
   VF_member   = 0x2000,   ///< used for member access
   VF_packed   = 0x4000,   ///< packed homogenious ravel
+
+  /// all flags indicating a ravel that does not consist of Cells
+  VF_typed    = VF_ints | VF_floats | VF_chars | VF_packed,
 };
 
 extern ostream & print_flags(ostream & out, ValueFlags flags);
@@ -179,7 +179,10 @@ const Value & v = *values[vid]._val;
 const Vid parent_vid = values[vid]._par;
 
    do_indent();
-   out << "<Value flg=\"" << HEX(v.get_flags()) << "\" "
+   // typed (but not packed) ravels are saved as Cells, see save_Ravel()
+   //
+   out << "<Value flg=\""
+       << HEX(v.get_flags() & ~(VF_ints | VF_floats | VF_chars)) << "\" "
                  "vid=\"" << vid                << "\" "
                  "parent=\"" << parent_vid      << "\" "
                  "rk=\"" << v.get_rank()        << "\"";
@@ -200,12 +203,11 @@ XML_Saving_Archive::save_Ravel(Vid vid)
 
 const Value & v = *values[vid]._val;
 const ShapeItem len = v.nz_element_count();
-const Cell * C = &v.get_cfirst();
 
 int space = do_indent();
-   if (v.is_packed())   // Value has a packed (non-Cell) ravel
+   if (const uint64_t * bits = v.get_packed_ravel())   // packed (non-Cell)
       {
-        const uint8_t * bytes = reinterpret_cast<const uint8_t *>(C);
+        const uint8_t * bytes = reinterpret_cast<const uint8_t *>(bits);
         const ShapeItem byte_count = (len + 7)/8;
 
         // print the start of the XML element
@@ -223,7 +225,7 @@ int space = do_indent();
         loop(b, byte_count)   // print with max. 64 bytes per line
             {
               if (b && (b & 0x3F) == 0)   out << "\n    " << UNI_PAD_U9;
-              out << (bytes[b] & 0xFF);
+              out << setw(2) << (bytes[b] & 0xFF);
             }
         out << nohex << "\"/>" << endl;
         --indent;
@@ -239,6 +241,7 @@ int space = do_indent();
 
         // print the data of the 'cells' attribute
         ++indent;
+        const Cell * C = &v.get_cfirst();
         loop(l, len)   emit_cell(*C++, space);
 
         space -= leave_char_mode();
@@ -1049,6 +1052,7 @@ ShapeItem idx = 0;
    loop(p, value_count)   // for every (parent-) value
       {
         const Value & parent = *values[p]._val;
+        if (parent.is_typed())   continue;   // (simple) non-Cell ravel
         const ShapeItem ec = parent.nz_element_count();
         loop(e, ec)   // for every ravel cell of the (parent-) value
             {
@@ -1770,7 +1774,8 @@ bool no_copy = false;   // assume the value is needed
         Assert(vid == int(values.size()));
         if (flags & VF_packed)
            {
-             Value_P val(sh_value, /* constructor allocates */ 0, LOC);
+             Value_P val(sh_value, /* constructor allocates */
+                         static_cast<uint64_t *>(0), LOC);
              values.push_back(val);
             }
         else
@@ -1900,12 +1905,18 @@ char **pend = reinterpret_cast<char **>(&end);
 
         case UNI_PAD_U9: // packed boolean
              Assert(Z.is_packed());
-             for (;;)
+             for (ShapeItem b = 0;;)
                  {
                    const uint8_t c0 = input[0];
                    const uint8_t c1 = input[1];
                    if (c0 <= ' ')    { ++input;   continue; }   // whitespace
                    if (c0 == '"')   return input + 1;   // end of ravel
+                   if (c0 >= 0x80)   // UNI_PAD_U9 of a continuation line
+                      {
+                        ++input;
+                        while ((*input & 0xC0) == 0x80)   ++input;
+                        continue;
+                      }
 
                    const char cc[3] = { char(c0), char(c1), 0 };
                    char * end = 0;
@@ -1914,7 +1925,7 @@ char **pend = reinterpret_cast<char **>(&end);
 
                    const int converted = end - cc;
                    if (converted == 0)   return input;   // nothing converted
-                   Z.next_ravel_Byte(byte);              // > 0 bytes converted
+                   Z.set_packed_byte(b++, byte);         // > 0 bytes converted
                    if (converted == 1)   return input + 1;
                  }
 
@@ -19,6 +19,7 @@
 */
 
 #include "Bif_F12_INDEX_OF.hh"
+#include "SearchIndex.hh"
 #include "Workspace.hh"
 
 Bif_F12_INDEX_OF Bif_F12_INDEX_OF ::_fun;    // ⍳
@@ -41,6 +42,14 @@ const ShapeItem ec = B->element_count();
         const APL_Integer len = B->get_cfirst().get_near_int();
         if (len < 0)   DOMAIN_ERROR;
 
+        if (len >= Value::TYPED_MINIMUM_LENGTH)   // long: typed ravel
+           {
+             APL_Integer * ints = Value::new_typed_ravel<APL_Integer>(len, LOC);
+             loop(z, len)   ints[z] = qio + z;
+             Value_P Z(Shape(len), ints, LOC);
+             return Token(TOK_APL_VALUE1, Z);
+           }
+
         Value_P Z(len, LOC);
 
         loop(z, len)   Z->next_ravel_Int(qio + z);
@@ -111,6 +120,52 @@ const APL_Integer qio = Workspace::get_IO();
 const ShapeItem len_A  = A->element_count();
 const ShapeItem len_BZ = B->element_count();
 
+   if (len_A >= 16 && len_BZ >= 4)   // try an index of A
+      {
+        const SearchIndex & index = A->get_search_cache().get_index();
+        if (index.is_valid())
+           {
+             APL_Integer * pos = Value::new_typed_ravel<APL_Integer>(len_BZ,
+                                                                    LOC);
+             const bool typed_Z = simple_result &&
+                                  len_BZ >= Value::TYPED_MINIMUM_LENGTH;
+             Value_P Z;
+             try
+                {
+                  index.find_all(*B, qct, pos);
+                  loop(bz, len_BZ)
+                     {
+                       if (pos[bz] == -1)   // compare B[bz] within ⎕CT
+                          pos[bz] = find_B_in_A(&A->get_cfirst(), len_A,
+                                                B->get_cravel(bz), qct);
+                     }
+
+                  if (!typed_Z)
+                     {
+                       Z = Value_P(B->get_shape(), LOC);
+                       loop(bz, len_BZ)
+                           next_Z_item(*Z, *A, pos[bz], simple_result, qio);
+                     }
+                }
+             catch (...)
+                {
+                  delete[] pos;
+                  throw;
+                }
+
+             if (typed_Z)   // Z takes over pos
+                {
+                  loop(bz, len_BZ)   pos[bz] += qio;
+                  Z = Value_P(B->get_shape(), pos, LOC);
+                  return Token(TOK_APL_VALUE1, Z);
+                }
+
+             delete[] pos;
+             Z->check_value(LOC);
+             return Token(TOK_APL_VALUE1, Z);
+           }
+      }
+
 Value_P Z(B->get_shape(), LOC);
 
 #if 1
@@ -120,34 +175,23 @@ Value_P Z(B->get_shape(), LOC);
       {
         // array A is being searched len_BZ times. We therefore reduce the
         // per-item search time from O(len_A) to O(log(len_A)). That costs us
-        // O(len_A × log(len_A)) for sorting A, but hopefully pays off if
+        // O(len_A × log(len_A)) for sorting A (once, since the sorted
+        // indices are cached with A), but hopefully pays off if
         // len_BZ > log(len_A).
         //
         // We don't do that for too small A though, as to compensate for the
         // start-up cost of the sorting.
         //
-        const ShapeItem * Idx_A = Cell::sorted_indices(&A->get_cfirst(), len_A,
-                                                       SORT_ASCENDING, 1);
+        const ShapeItem * Idx_A =
+              A->get_search_cache().get_sorted(len_A, &Cell::greater_cp);
         loop(bz, len_BZ)
             {
               const APL_Integer z = find_B_in_sorted_A(&A->get_cfirst(),
                                                        len_A, Idx_A,
                                                        B->get_cravel(bz), qct);
 
-              if (simple_result)   Z->next_ravel_Int(qio + z);
-              else if (z == len_A)   // not found: set result item to ⍬
-                 {
-                   Value_P zilde(ShapeItem(0), LOC);
-                   Z->next_ravel_Pointer(zilde.get());
-                 }
-              else                   // element found (first at z (+⎕IO)
-                 {
-                   const Shape Sz = A->get_shape().offset_to_index(z, qio);
-                   Value_P Vz(LOC, &Sz);
-                   Z->next_ravel_Pointer(Vz.get());
-                 }
+              next_Z_item(*Z, *A, z, simple_result, qio);
             }
-        delete[] Idx_A;
       }
    else
 #endif
@@ -157,18 +201,7 @@ Value_P Z(B->get_shape(), LOC);
               const APL_Integer z = find_B_in_A(&A->get_cfirst(), len_A,
                                                 B->get_cravel(bz), qct);
 
-              if (simple_result)   Z->next_ravel_Int(qio + z);
-              else if (z == len_A)   // not found: set result item to ⍬
-                 {
-                   Value_P zilde(ShapeItem(0), LOC);
-                   Z->next_ravel_Pointer(zilde.get());
-                 }
-              else                   // element found (first at z (+⎕IO)
-                 {
-                   const Shape Sz = A->get_shape().offset_to_index(z, qio);
-                   Value_P Vz(LOC, &Sz);
-                   Z->next_ravel_Pointer(Vz.get());
-                 }
+              next_Z_item(*Z, *A, z, simple_result, qio);
             }
       }
 
@@ -176,6 +209,24 @@ Value_P Z(B->get_shape(), LOC);
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+void
+Bif_F12_INDEX_OF::next_Z_item(Value & Z, const Value & A, ShapeItem z,
+                              bool simple_result, APL_Integer qio)
+{
+   if (simple_result)   Z.next_ravel_Int(qio + z);
+   else if (z == A.element_count())   // not found: set result item to ⍬
+      {
+        Value_P zilde(ShapeItem(0), LOC);
+        Z.next_ravel_Pointer(zilde.get());
+      }
+   else                               // element found (first at z (+⎕IO)
+      {
+        const Shape Sz = A.get_shape().offset_to_index(z, qio);
+        Value_P Vz(LOC, &Sz);
+        Z.next_ravel_Pointer(Vz.get());
+      }
+}
+//----------------------------------------------------------------------------
 int
 Bif_F12_INDEX_OF::bs_cmp(const Cell & cell, const ShapeItem & A,
                          const void * ctx)
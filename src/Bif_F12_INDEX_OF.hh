@@ -59,6 +59,11 @@ protected:
                                        const ShapeItem * Idx_A,
                                        const Cell & cell_B, double qct);
 
+   /// append the item of A⍳B for the position \b z (< len_A if found)
+   /// of an item of B in A to \b Z
+   static void next_Z_item(Value & Z, const Value & A, ShapeItem z,
+                           bool simple_result, APL_Integer qio);
+
    /// compare function for Heapsort<ShapeItem>::search<const Cell &>
    static int bs_cmp(const Cell & cell, const ShapeItem & A, const void * ctx);
 };
@@ -19,8 +19,15 @@
 */
 
 #include "Bif_F12_INTERVAL_INDEX.hh"
+#include "ComplexCell.hh"
+#include "Parallel.hh"
+#include "ScalarKernels.hh"
+#include "SearchIndex.hh"
+#include "Thread_context.hh"
 #include "Workspace.hh"
 
+#include "Cell.icc"
+
 Bif_F12_INTERVAL_INDEX Bif_F12_INTERVAL_INDEX::_fun;    // ⍳
 
 Bif_F12_INTERVAL_INDEX *
@@ -114,18 +121,37 @@ const ShapeItem ec_A = A->element_count();
         LENGTH_ERROR;
       }
 
-   for(ShapeItem a = 1; a < ec_A; ++a)
-       {
-         const Cell & c1 = A->get_cravel(a-1);
-         const Cell & c2 = A->get_cravel(a);
-         const Comp_result c1_c2 = c1.compare(c2);
-         if (c1_c2 != COMP_LT)
+   // A and B with only integers or only reals are searched without Cells
+   //
+   {
+     Kernel_arg arg_A(*A);
+     Kernel_arg arg_B(*B);
+     if (arg_A.type != CT_NONE && arg_B.type != CT_NONE)
+        {
+          Value_P Z = typed_eval_AB(*A, arg_A, *B, arg_B);
+          return Token(TOK_APL_VALUE1, Z);
+        }
+   }
+
+   // check that A is sorted (unless that was cached with A already)
+   //
+SearchCache & cache = A->get_search_cache();
+   if (!cache.is_ascending())
+      {
+        for(ShapeItem a = 1; a < ec_A; ++a)
             {
-              MORE_ERROR() << "the left argument of A ⍸ B "
-                              "is not sorted ascendingly";
-              DOMAIN_ERROR;
+              const Cell & c1 = A->get_cravel(a-1);
+              const Cell & c2 = A->get_cravel(a);
+              const Comp_result c1_c2 = c1.compare(c2);
+              if (c1_c2 != COMP_LT)
+                 {
+                   MORE_ERROR() << "the left argument of A ⍸ B "
+                                   "is not sorted ascendingly";
+                   DOMAIN_ERROR;
+                 }
             }
-       }
+        cache.set_ascending();
+      }
 
    // from here on nothing can fail.
    //
@@ -145,6 +171,197 @@ const APL_Integer qio = Workspace::get_IO();
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+/// store the number of items of the sorted \b A (of length \b len_A) that
+/// are ≤ B[b] into Z[b] for all b in [from, to). The branch-free binary
+/// searches of GROUP items of B are interleaved so that their memory
+/// accesses overlap.
+template<typename T>
+static void
+count_less_equal(const T * A, ShapeItem len_A, const T * B,
+                 ShapeItem from, ShapeItem to, APL_Integer * Z)
+{
+   enum { GROUP = Bif_F12_INTERVAL_INDEX::SEARCH_GROUP };
+
+ShapeItem b = from;
+   for (; b + GROUP <= to; b += GROUP)
+       {
+         ShapeItem base[GROUP];
+         loop(g, GROUP)   base[g] = 0;
+
+         // A[0] ... A[base[g] - 1] are ≤ B[b + g], A[base[g] + n] ... are not
+         //
+         for (ShapeItem n = len_A; n > 1;)
+             {
+               const ShapeItem half = n >> 1;
+               loop(g, GROUP)
+                   base[g] += (A[base[g] + half] <= B[b + g]) ? half : 0;
+               n -= half;
+             }
+
+         loop(g, GROUP)   Z[b + g] = base[g] + (A[base[g]] <= B[b + g]);
+       }
+
+   for (; b < to; ++b)   // the remaining items
+       {
+         ShapeItem base = 0;
+         for (ShapeItem n = len_A; n > 1;)
+             {
+               const ShapeItem half = n >> 1;
+               base += (A[base + half] <= B[b]) ? half : 0;
+               n -= half;
+             }
+         Z[b] = base + (A[base] <= B[b]);
+       }
+}
+//----------------------------------------------------------------------------
+/// the state of a typed A ⍸ B
+struct Interval_job
+{
+   /// the items of A if integer (else 0)
+   const APL_Integer * ints_A;
+
+   /// the items of A if real (else 0)
+   const APL_Float * reals_A;
+
+   /// the number of items in A
+   ShapeItem len_A;
+
+   /// the items of B if integer (else 0)
+   const APL_Integer * ints_B;
+
+   /// the items of B if real (else 0)
+   const APL_Float * reals_B;
+
+   /// the result
+   APL_Integer * Z;
+
+   /// ⎕CT (for real A or B)
+   double qct;
+
+   /// ⎕IO
+   APL_Integer qio;
+};
+
+static Interval_job interval_job;
+
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of \b job
+static void
+do_interval_items(const Interval_job & job, ShapeItem from, ShapeItem to)
+{
+   if (job.ints_A)   // integer A and B: exact comparisons
+      {
+        count_less_equal(job.ints_A, job.len_A, job.ints_B, from, to, job.Z);
+      }
+   else              // real A or B: A[z] that are tolerantly equal to B[b]
+      {              // are also ≤ B[b]
+        count_less_equal(job.reals_A, job.len_A, job.reals_B, from, to,
+                         job.Z);
+        if (job.qct != 0.0)
+           {
+             for (ShapeItem b = from; b < to; ++b)
+                 {
+                   APL_Integer & z = job.Z[b];
+                   while (z < job.len_A &&
+                          Cell::tolerantly_equal(job.reals_A[z],
+                                                 job.reals_B[b], job.qct))
+                         ++z;
+                 }
+           }
+      }
+
+   // the number of A items ≤ B[b] is the (⎕IO-0) index of the interval + 1
+   //
+const APL_Integer offset = job.qio - 1;
+   for (ShapeItem b = from; b < to; ++b)   job.Z[b] += offset;
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+/// the pool function of a parallel A ⍸ B
+static void
+PF_interval(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+         do_interval_items(interval_job, from, to);
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+Value_P
+Bif_F12_INTERVAL_INDEX::typed_eval_AB(const Value & A, Kernel_arg & arg_A,
+                                      const Value & B, Kernel_arg & arg_B)
+{
+const ShapeItem len_A = A.element_count();
+const ShapeItem len_B = B.element_count();
+const double qct = Workspace::get_CT();
+
+   // Cell::compare() of integers is exact, but tolerant if a real is
+   // involved. Integer A and B are therefore searched as integers, and
+   // otherwise as reals.
+   //
+const bool reals = arg_A.type != CT_INT || arg_B.type != CT_INT;
+
+   interval_job.ints_A  = reals ? 0 : arg_A.ints;
+   interval_job.reals_A = reals ? arg_A.get_reals(len_A) : 0;
+   interval_job.len_A   = len_A;
+   interval_job.ints_B  = reals ? 0 : arg_B.ints;
+   interval_job.reals_B = reals ? arg_B.get_reals(len_B) : 0;
+   interval_job.qct     = qct;
+   interval_job.qio     = Workspace::get_IO();
+
+   // check that A is sorted (unless that was cached with A already)
+   //
+SearchCache & cache = A.get_search_cache();
+   if (!cache.is_ascending())
+      {
+        for (ShapeItem a = 1; a < len_A; ++a)
+            {
+              const bool ascending = (arg_A.type == CT_INT)
+                 ? arg_A.ints[a - 1] < arg_A.ints[a]
+                 : interval_job.reals_A[a - 1] < interval_job.reals_A[a] &&
+                   !Cell::tolerantly_equal(interval_job.reals_A[a - 1],
+                                           interval_job.reals_A[a], qct);
+              if (!ascending)
+                 {
+                   MORE_ERROR() << "the left argument of A ⍸ B "
+                                   "is not sorted ascendingly";
+                   DOMAIN_ERROR;
+                 }
+            }
+        cache.set_ascending();
+      }
+
+APL_Integer * ints_Z = Value::new_typed_ravel<APL_Integer>(len_B, LOC);
+   interval_job.Z = ints_Z;
+
+#if PARALLEL_ENABLED
+const CoreCount cores = Thread_context::get_active_core_count();
+   if (Parallel::run_parallel && cores > 1 &&
+       len_B > Bif_F12_INTERVAL_INDEX::fun->get_dyadic_threshold())
+      {
+        Thread_context::M_distribute_work(len_B, cores);
+        Thread_context::do_work = PF_interval;
+        Thread_context::M_fork("interval_index");   // start pool
+        PF_interval(Thread_context::get_master());
+        Thread_context::M_join();
+      }
+   else
+#endif // PARALLEL_ENABLED
+      {
+        do_interval_items(interval_job, 0, len_B);
+      }
+
+   if (len_B >= Value::TYPED_MINIMUM_LENGTH)
+      return Value_P(B.get_shape(), ints_Z, LOC);
+
+Value_P Z(B.get_shape(), LOC);
+   loop(z, len_B)   Z->next_ravel_Int(ints_Z[z]);
+   delete[] ints_Z;
+   Z->set_proto_Int();
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
 ShapeItem
 Bif_F12_INTERVAL_INDEX::find_range(const Cell & cell, const Cell * ranges,
                                    ShapeItem range_count)
@@ -23,6 +23,8 @@
 
 #include "PrimitiveFunction.hh"
 
+class Kernel_arg;
+
 //----------------------------------------------------------------------------
 /** System function interval index (⍸) */
 /// The class implementing ⍸
@@ -32,7 +34,7 @@ public:
    /// Constructor
    Bif_F12_INTERVAL_INDEX()
    : NonscalarFunction(TOK_F12_INTERVAL_INDEX)
-   {}
+   { set_dyadic_threshold(Performance::thresh_F12_INTERVAL_INDEX_AB); }
 
    /// overloaded Function::eval_B()
    virtual Token eval_B(Value_P B) const;
@@ -43,7 +45,15 @@ public:
    static Bif_F12_INTERVAL_INDEX * fun;   ///< Built-in function
    static Bif_F12_INTERVAL_INDEX  _fun;   ///< Built-in function
 
+   /// the number of B items whose searches in A are interleaved
+   enum { SEARCH_GROUP = 8 };
+
 protected:
+   /// compute A ⍸ B for A and B with only integers or only reals (as
+   /// given by \b arg_A and \b arg_B)
+   static Value_P typed_eval_AB(const Value & A, Kernel_arg & arg_A,
+                                const Value & B, Kernel_arg & arg_B);
+
    /// find cell in ranges defined by ranges and range_count
    static ShapeItem find_range(const Cell & cell, const Cell * ranges,
                                ShapeItem range_count);
@@ -21,11 +21,18 @@
 #include "Assert.hh"
 #include "Bif_F12_SORT.hh"
 #include "Cell.hh"
+#include "ComplexCell.hh"
 #include "Heapsort.hh"
 #include "Macro.hh"
+#include "Mergesort.hh"
+#include "Parallel.hh"
+#include "Radixsort.hh"
+#include "Thread_context.hh"
 #include "Value.hh"
 #include "Workspace.hh"
 
+#include "Cell.icc"
+
 Bif_F12_SORT_ASC  Bif_F12_SORT_ASC::_fun;     // ⍋
 Bif_F12_SORT_DES  Bif_F12_SORT_DES::_fun;     // ⍒
 
@@ -84,13 +91,13 @@ CollatingCacheEntry others(Invalid_Unicode, A.get_shape());
 }
 //----------------------------------------------------------------------------
 bool
-CollatingCache::greater_vec(const IntCell & Za, const IntCell & Zb,
+CollatingCache::greater_vec(const ShapeItem & Za, const ShapeItem & Zb,
                             const void * comp_arg)
 {
 const CollatingCache & cache =
                       *reinterpret_cast<const CollatingCache *>(comp_arg);
-const Cell * ca = cache.base_B1 + cache.comp_len * Za.get_int_value();
-const Cell * cb = cache.base_B1 + cache.comp_len * Zb.get_int_value();
+const Cell * ca = cache.base_B1 + cache.comp_len * Za;
+const Cell * cb = cache.base_B1 + cache.comp_len * Zb;
 
 const sRank rank = cache.get_rank();
 
@@ -110,13 +117,13 @@ const sRank rank = cache.get_rank();
 }
 //----------------------------------------------------------------------------
 bool
-CollatingCache::smaller_vec(const IntCell & Za, const IntCell & Zb,
+CollatingCache::smaller_vec(const ShapeItem & Za, const ShapeItem & Zb,
                             const void * comp_arg)
 {
 const CollatingCache & cache =
                       *reinterpret_cast<const CollatingCache *>(comp_arg);
-const Cell * ca = cache.base_B1 + cache.comp_len * Za.get_int_value();
-const Cell * cb = cache.base_B1 + cache.comp_len * Zb.get_int_value();
+const Cell * ca = cache.base_B1 + cache.comp_len * Za;
+const Cell * cb = cache.base_B1 + cache.comp_len * Zb;
 const sRank rank = cache.get_rank();
 
    loop(r, rank)
@@ -157,12 +164,28 @@ const ShapeItem len_BZ = B->get_shape_item(0);
    if (len_BZ == 0)   return Token(TOK_APL_VALUE1, Idx0(LOC));
 const ShapeItem comp_len = B->element_count()/len_BZ;
 
-const ShapeItem * indices = Cell::sorted_indices(&B->get_cfirst(),
-                                                 len_BZ, order, comp_len);
+const int qio = Workspace::get_IO();
+const CoreCount cores = grade_cores(len_BZ, order);
+   if (ShapeItem * indices = radix_grade(*B, len_BZ, comp_len, order, cores))
+      {
+        // indices are the ravel of Z
+        //
+        APL_Integer * ints_Z = reinterpret_cast<APL_Integer *>(indices);
+        loop(z, len_BZ)   ints_Z[z] += qio;
+        return Token(TOK_APL_VALUE1, Value_P(Shape(len_BZ), ints_Z, LOC));
+      }
+
+   // nested items are compared by PointerCell::compare(), which copies
+   // Value_P and may explode the typed ravels of the sub-values. That is not
+   // thread-safe, so only simple values are sorted in parallel.
+   //
+const Cell * base_B = &B->get_cfirst();   // explodes a typed B (here)
+const ShapeItem * indices = Cell::sorted_indices(base_B, len_BZ, order,
+                                                 comp_len, B->is_simple()
+                                                         ? cores : CCNT_1);
    if (indices == 0)   WS_FULL;
 
 Value_P Z(len_BZ, LOC);
-const int qio = Workspace::get_IO();
 
    loop(a, len_BZ)   Z->next_ravel_Int(indices[a] + qio);
    delete[] indices;
@@ -171,6 +194,177 @@ const int qio = Workspace::get_IO();
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+CoreCount
+Bif_F12_SORT::grade_cores(ShapeItem len_BZ, Sort_order order)
+{
+#if PARALLEL_ENABLED
+const CoreCount cores = Thread_context::get_active_core_count();
+const Function * fun = (order == SORT_ASCENDING)
+                     ? static_cast<const Function *>(Bif_F12_SORT_ASC::fun)
+                     : static_cast<const Function *>(Bif_F12_SORT_DES::fun);
+   if (Parallel::run_parallel && cores > 1 &&
+       len_BZ > fun->get_monadic_threshold())   return cores;
+#endif // PARALLEL_ENABLED
+
+   return CCNT_1;
+}
+//----------------------------------------------------------------------------
+ShapeItem *
+Bif_F12_SORT::radix_grade(const Value & B, ShapeItem len_BZ,
+                          ShapeItem comp_len, Sort_order order,
+                          CoreCount cores)
+{
+   if (len_BZ < RADIX_MINIMUM_LENGTH)   return 0;
+
+const ShapeItem ec_B = B.element_count();
+
+   // 1. compute the keys of all ravel items of B. Reals are compared within
+   //    ⎕CT, which is fixed afterwards for vectors but not for matrices.
+   //
+uint64_t * keys_B = Value::new_typed_ravel<uint64_t>(ec_B, LOC);
+bool reals = false;
+   if (const APL_Integer * ints = B.get_int_ravel())
+      {
+        loop(b, ec_B)   keys_B[b] = Radixsort::int_key(ints[b]);
+      }
+   else if (const APL_Float * floats = B.get_float_ravel())
+      {
+        reals = true;
+        loop(b, ec_B)   keys_B[b] = Radixsort::real_key(floats[b]);
+      }
+   else if (const Unicode * chars = B.get_char_ravel())
+      {
+        loop(b, ec_B)   keys_B[b] = Radixsort::char_key(chars[b]);
+      }
+   else if (const uint64_t * bits = B.get_packed_ravel())
+      {
+        loop(b, ec_B)   keys_B[b] = Radixsort::int_key(bits[b >> 6] >> (b & 63) & 1);
+      }
+   else   // Cell ravel: only integers, only characters, or integers and reals
+      {
+        const CellType type_0 = B.get_cfirst().get_cell_type();
+        loop(b, ec_B)
+           {
+             const Cell & cell_B = B.get_cravel(b);
+             const CellType type_B = cell_B.get_cell_type();
+             if (type_0 == CT_CHAR && type_B == CT_CHAR)
+                {
+                  keys_B[b] = Radixsort::char_key(cell_B.get_char_value());
+                }
+             else if (type_0 == CT_CHAR || type_B == CT_CHAR)   // mixed
+                {
+                  delete[] keys_B;
+                  return 0;
+                }
+             else if (type_B == CT_FLOAT)
+                {
+                  reals = true;
+                  keys_B[b] = Radixsort::real_key(cell_B.get_real_value());
+                }
+             else if (type_B == CT_INT)
+                {
+                  keys_B[b] = Radixsort::int_key(cell_B.get_int_value());
+                }
+             else   // complex (but near real) or nested
+                {
+                  delete[] keys_B;
+                  return 0;
+                }
+           }
+
+        // integers and reals: the integers need real keys
+        //
+        if (reals && !B.get_float_ravel())
+           {
+             loop(b, ec_B)
+                {
+                  const Cell & cell_B = B.get_cravel(b);
+                  if (!cell_B.is_integer_cell())   continue;
+
+                  const APL_Integer value = cell_B.get_int_value();
+                  if (value < -0x20000000000000LL || value > 0x20000000000000LL)
+                     {
+                       // not exact as APL_Float
+                       delete[] keys_B;
+                       return 0;
+                     }
+                  keys_B[b] = Radixsort::real_key(value);
+                }
+           }
+      }
+
+   if (reals && comp_len != 1)
+      {
+        delete[] keys_B;
+        return 0;
+      }
+
+   // 2. sort the indices of the items by their last ravel item, then
+   //    (stably) by their second last ravel item, and so on.
+   //
+const uint64_t flip = (order == SORT_ASCENDING) ? 0 : ~uint64_t(0);
+ShapeItem * indices = 0;
+uint64_t * keys = 0;
+   try
+      {
+        indices = Value::new_typed_ravel<ShapeItem>(len_BZ, LOC);
+        keys    = Value::new_typed_ravel<uint64_t>(len_BZ, LOC);
+        loop(z, len_BZ)   indices[z] = z;
+
+        for (ShapeItem c = comp_len - 1; c >= 0; --c)
+            {
+              loop(z, len_BZ)   keys[z] = keys_B[indices[z]*comp_len + c] ^ flip;
+              Radixsort::sort(keys, indices, len_BZ, cores);
+            }
+      }
+   catch (...)
+      {
+        delete[] keys_B;
+        delete[] keys;
+        delete[] indices;
+        throw;
+      }
+
+   delete[] keys;
+   delete[] keys_B;
+
+   if (reals)   tolerant_ties(B, indices, len_BZ);
+   return indices;
+}
+//----------------------------------------------------------------------------
+void
+Bif_F12_SORT::tolerant_ties(const Value & B, ShapeItem * indices,
+                            ShapeItem len_BZ)
+{
+const double qct = Workspace::get_CT();
+   if (qct == 0.0)   return;
+
+const APL_Float * floats = B.get_float_ravel();
+ShapeItem from = 0;
+   while (from < len_BZ)
+      {
+        // find the items that are equal to indices[from] within ⎕CT
+        //
+        const APL_Float first = floats ? floats[indices[from]]
+                                       : B.get_cravel(indices[from])
+                                          .get_real_value();
+        ShapeItem to = from + 1;
+        while (to < len_BZ)
+           {
+             const APL_Float next = floats ? floats[indices[to]]
+                                           : B.get_cravel(indices[to])
+                                              .get_real_value();
+             if (!Cell::tolerantly_equal(first, next, qct))   break;
+             ++to;
+           }
+
+        if (to - from > 1)   // ties
+           Heapsort<ShapeItem>::sort(indices + from, to - from, 0,
+                                     &greater_index);
+        from = to;
+      }
+}
+//----------------------------------------------------------------------------
 Token
 Bif_F12_SORT::sort_collating(Value_P A, Value_P B, Sort_order order)
 {
@@ -184,12 +378,13 @@ const APL_Integer qio = Workspace::get_IO();
 const ShapeItem len_BZ = B->get_shape_item(0);
    if (len_BZ == 0)   return Token(TOK_APL_VALUE1, Idx0(LOC));
 
-   // first set Z←⍳len_BZ
-   //
-Value_P Z(len_BZ, LOC);
-   loop(l, len_BZ)   Z->next_ravel_Int(l + qio);
-   Z->check_value(LOC);
-   if (len_BZ == 1)   return Token(TOK_APL_VALUE1, Z);
+   if (len_BZ == 1)
+      {
+        Value_P Z(len_BZ, LOC);
+        Z->next_ravel_Int(qio);
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
 
 const ShapeItem ec_B = B->element_count();
 const ShapeItem comp_len = ec_B/len_BZ;
@@ -199,7 +394,7 @@ const ShapeItem comp_len = ec_B/len_BZ;
    // index for each character in B.
    //
 Value_P B1(B->get_shape(), LOC);
-const Cell * base_B1 = &B1->get_cfirst() - qio*comp_len;
+const Cell * base_B1 = &B1->get_cfirst();
 CollatingCache cache(*A, base_B1, comp_len);
    loop(b, ec_B)
       {
@@ -209,13 +404,22 @@ CollatingCache cache(*A, base_B1, comp_len);
       }
    B1->check_value(LOC);
 
-   // then sort Z (actually re-arrange Z so that B[Z] is sorted)
+   // then sort the indices of the items of B so that B[indices] is sorted
    //
-IntCell * Z0 = reinterpret_cast<IntCell *>(&Z->get_wfirst());
+ShapeItem * indices = Value::new_typed_ravel<ShapeItem>(len_BZ, LOC);
+   loop(z, len_BZ)   indices[z] = z;
+
+const CoreCount cores = grade_cores(len_BZ, order);
    if (order == SORT_ASCENDING)
-      Heapsort<IntCell>::sort(Z0, len_BZ, &cache, &CollatingCache::greater_vec);
+      Mergesort::sort(indices, len_BZ, &cache, &CollatingCache::greater_vec,
+                      cores);
    else
-      Heapsort<IntCell>::sort(Z0, len_BZ, &cache, &CollatingCache::smaller_vec);
+      Mergesort::sort(indices, len_BZ, &cache, &CollatingCache::smaller_vec,
+                      cores);
+
+Value_P Z(len_BZ, LOC);
+   loop(z, len_BZ)   Z->next_ravel_Int(indices[z] + qio);
+   delete[] indices;
 
    Z->check_value(LOC);
    return Token(TOK_APL_VALUE1, Z);
@@ -105,14 +105,14 @@ public:
    /// find (the index of) the entry for \b uni
    ShapeItem find_entry(Unicode uni) const;
 
-   /// compare cache items \b ia and \b ib ascendingly.
+   /// compare the items \b ia and \b ib of B ascendingly.
    /// \b comp_arg is a CollatingCache pointer
-   static bool greater_vec(const IntCell & ia, const IntCell & ib,
+   static bool greater_vec(const ShapeItem & ia, const ShapeItem & ib,
                            const void * comp_arg);
 
-   /// compare cache items \b ia and \b ib descendingly.
+   /// compare the items \b ia and \b ib of B descendingly.
    /// \b comp_arg is a CollatingCache pointer
-   static bool smaller_vec(const IntCell & ia, const IntCell & ib,
+   static bool smaller_vec(const ShapeItem & ia, const ShapeItem & ib,
                            const void * comp_arg);
 
 protected:
@@ -120,7 +120,7 @@ protected:
    const sRank rank;
 
    
-   /// start of B.s ravel, ⎕IO adjusted
+   /// start of B1's ravel (the cache indices of the chars of B)
    const Cell * base_B1;
 
    /// the number of items to compare
@@ -142,6 +142,30 @@ public:
    static Token sort(Value_P B, Sort_order order);
 
 protected:
+   /// the smallest number of items that are graded with a Radixsort
+   enum { RADIX_MINIMUM_LENGTH = 32 };
+
+   /// return the number of cores for grading \b len_BZ items
+   static CoreCount grade_cores(ShapeItem len_BZ, Sort_order order);
+
+   /// return the indices of the items of B (of \b len_BZ items with
+   /// \b comp_len ravel items each) in the order \b order if B has only
+   /// integers, only characters, or only reals (of a single ravel item),
+   /// or else 0.
+   static ShapeItem * radix_grade(const Value & B, ShapeItem len_BZ,
+                                  ShapeItem comp_len, Sort_order order,
+                                  CoreCount cores);
+
+   /// put the indices of the items in \b indices that are equal within
+   /// ⎕CT into ascending order (like Cell::greater_cp() does)
+   static void tolerant_ties(const Value & B, ShapeItem * indices,
+                             ShapeItem len_BZ);
+
+   /// compare function for Heapsort<ShapeItem>: return true if \b a > \b b
+   static bool greater_index(const ShapeItem & a, const ShapeItem & b,
+                             const void * unused_ctx)
+      { return a > b; }
+
    /// a helper structure for sorting: a char and a shape
    struct char_shape
       {
@@ -166,7 +190,7 @@ public:
    /// Constructor
    Bif_F12_SORT_ASC()
    : Bif_F12_SORT(TOK_F12_SORT_ASC)
-   {}
+   { set_monadic_threshold(Performance::thresh_F12_SORT_ASC_B); }
 
    /// overloaded Function::eval_B()
    virtual Token eval_B(Value_P B) const
@@ -193,7 +217,7 @@ public:
    /// Constructor
    Bif_F12_SORT_DES()
    : Bif_F12_SORT(TOK_F12_SORT_DES)
-   {}
+   { set_monadic_threshold(Performance::thresh_F12_SORT_DES_B); }
 
    /// overloaded Function::eval_B()
    virtual Token eval_B(Value_P B) const
@@ -20,6 +20,8 @@
 
 #include "Bif_F12_TAKE_DROP.hh"
 #include "Bif_OPER1_EACH.hh"
+#include "Bif_OPER1_REDUCE.hh"
+#include "DerivedFunction.hh"
 #include "Macro.hh"
 #include "PointerCell.hh"
 #include "UserFunction.hh"
@@ -277,6 +279,11 @@ const ShapeItem len_Z = B->element_count();
 Value_P Z;
    if (LO->has_result())   Z = Value_P(B->get_shape(), LOC);
 
+   // left values (e.g. (↑¨B)←...) need the Cell references made by LO
+   //
+const Direct_LO direct = B->get_cfirst().is_lval_cell() ? DIRECT_NONE
+                                                         : direct_LO(LO);
+
    loop (z, len_Z)
       {
         if (LO->get_fun_valence() == 0)
@@ -306,6 +313,8 @@ Value_P Z;
         else
            {
              const Cell * cB = &B->get_cravel(z);
+             if (direct && direct_item(direct, *Z, *cB))   continue;   // next z
+
              const bool left_val = cB->is_lval_cell();
              Value_P LO_B = cB->to_value(LOC);      // right argument of LO
 
@@ -347,4 +356,105 @@ Value_P Z;
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+Bif_OPER1_EACH::Direct_LO
+Bif_OPER1_EACH::direct_LO(Function_P LO)
+{
+   if (LO == Bif_F12_NEQUIV::fun)   return DIRECT_TALLY;
+   if (LO == Bif_F12_RHO::fun)      return DIRECT_SHAPE;
+   if (LO == Bif_F12_TAKE::fun)     return DIRECT_FIRST;
+
+   if (LO->is_derived())
+      {
+        const DerivedFunction * derived =
+                                static_cast<const DerivedFunction *>(LO);
+        if (derived->get_OPER() == Bif_OPER1_REDUCE::fun &&
+            !derived->get_AXIS()                         &&
+            !derived->get_bound_LO_value()               &&
+            derived->get_LO()->get_scalar_f2() == &Cell::bif_add)
+           return DIRECT_SUM;
+      }
 
+   return DIRECT_NONE;
+}
+//----------------------------------------------------------------------------
+bool
+Bif_OPER1_EACH::direct_item(Direct_LO direct, Value & Z, const Cell & item_B)
+{
+const Value * V = item_B.is_pointer_cell() ? item_B.get_pointer_value().get()
+                                           : 0;   // 0 means simple scalar
+   switch(direct)
+      {
+        case DIRECT_TALLY:
+             Z.next_ravel_Int((!V || V->is_scalar()) ? 1
+                                                     : V->get_shape_item(0));
+             return true;
+
+        case DIRECT_SHAPE:
+             {
+               const sRank rank = V ? V->get_rank() : 0;
+               Value_P Z1(rank, LOC);
+               loop(r, rank)   Z1->next_ravel_Int(V->get_shape_item(r));
+               Z1->check_value(LOC);
+               Z.next_ravel_Pointer(Z1.get());
+               return true;
+             }
+
+        case DIRECT_FIRST:
+             if (!V)   // ↑ of a simple scalar is the scalar
+                {
+                  Z.next_ravel_Cell(item_B);
+                  return true;
+                }
+
+             // an empty item (prototype) or a nested first item needs a new
+             // value
+             //
+             if (V->is_empty() || V->get_cfirst().is_pointer_cell())
+                return false;
+
+             Z.next_ravel_Cell(V->get_cfirst());
+             return true;
+
+        case DIRECT_SUM:
+             {
+               // non-empty integer vectors only; anything else (including
+               // an integer overflow) is left to LO
+               //
+               if (!V || V->get_rank() != 1 || V->is_empty())   return false;
+
+               const ShapeItem len = V->element_count();
+               APL_Integer sum = 0;
+               if (const uint64_t * bits = V->get_packed_ravel())
+                  {
+                    sum = Value::count_packed_bits(bits, 0, len);
+                  }
+               else if (const APL_Integer * ints = V->get_int_ravel())
+                  {
+                    loop(l, len)
+                       {
+                         const APL_Integer s = sum + ints[l];
+                         if (Cell::sum_overflow(s, sum, ints[l]))
+                            return false;
+                         sum = s;
+                       }
+                  }
+               else
+                  {
+                    loop(l, len)
+                       {
+                         const Cell & cV = V->get_cravel(l);
+                         if (!cV.is_integer_cell())   return false;
+                         const APL_Integer v = cV.get_int_value();
+                         const APL_Integer s = sum + v;
+                         if (Cell::sum_overflow(s, sum, v))   return false;
+                         sum = s;
+                       }
+                  }
+               Z.next_ravel_Int(sum);
+               return true;
+             }
+
+        default: return false;
+      }
+}
+//----------------------------------------------------------------------------
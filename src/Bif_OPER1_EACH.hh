@@ -47,6 +47,24 @@ public:
    static Token do_eval_LB(Token & LO, Value_P B);
 
 protected:
+   /// primitive functions LO for which the items of LO¨B are computed
+   /// directly (i.e. without calling LO)
+   enum Direct_LO
+      {
+        DIRECT_NONE = 0,   ///< call LO
+        DIRECT_TALLY,      ///< ≢¨B
+        DIRECT_SHAPE,      ///< ⍴¨B
+        DIRECT_FIRST,      ///< ↑¨B
+        DIRECT_SUM,        ///< +/¨B
+      };
+
+   /// return how the items of LO¨B can be computed directly
+   static Direct_LO direct_LO(Function_P LO);
+
+   /// append LO item_B to Z (without calling LO) and return \b true, or
+   /// else return \b false (and then LO shall be called)
+   static bool direct_item(Direct_LO direct, Value & Z, const Cell & item_B);
+
    /// overloaded Function::may_push_SI()
    virtual bool may_push_SI() const
       { return false; }
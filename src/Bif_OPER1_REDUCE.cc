@@ -22,7 +22,11 @@
 
 #include "Bif_OPER1_REDUCE.hh"
 #include "Macro.hh"
+#include "Parallel.hh"
 #include "PointerCell.hh"
+#include "ScalarFunction.hh"
+#include "ScalarKernels.hh"
+#include "Thread_context.hh"
 #include "Workspace.hh"
 
 Bif_OPER1_REDUCE    Bif_OPER1_REDUCE ::_fun;
@@ -63,9 +67,12 @@ std::vector<ShapeItem> rep_counts;
    else
       {
         ShapeItem geq_A = 0;   // number of items >= 0 in A
+        const uint64_t * bits_A = A->get_packed_ravel();   // compress
         loop(a, len_A)
            {
-             APL_Integer rep_A = A->get_cravel(a).get_near_int();
+             APL_Integer rep_A = bits_A
+                               ? APL_Integer((bits_A[a >> 6] >> (a & 63)) & 1)
+                               : A->get_cravel(a).get_near_int();
              rep_counts.push_back(rep_A);
              if (rep_A > 0)        { len_Z += rep_A;   ++geq_A; }
              else if (rep_A < 0)   len_Z -= rep_A;
@@ -170,7 +177,25 @@ const Shape shape_Z = B->get_shape().without_axis(axis);
    // non-trivial reduce (len > 1)
    //
 const Shape3 B3(B->get_shape(), axis);
-   if (LO->may_push_SI())   // user defined LO
+   if (const uint64_t * bits = B->get_packed_ravel())
+      {
+        Value_P Z = reduce_packed(LO, bits, shape_Z, B3);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
+   if (!LO->may_push_SI())
+      {
+        Value_P Z = reduce_typed(LO, *B, shape_Z, B3);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
+   if (LO->get_func_ufun())   // defined function LO
+      {
+        const Shape3 Z3(B3.h(), 1, B3.l());
+        return reduce_defined(LO, B, shape_Z, Z3, B3.m(), B3.m());
+      }
+
+   if (LO->may_push_SI())   // derived function LO with a defined function
       {
         Value_P X4(4, LOC);
         X4->next_ravel_Int(axis + Workspace::get_IO());
@@ -186,6 +211,409 @@ const Shape3 Z3(B3.h(), 1, B3.l());
    return do_reduce(shape_Z, Z3, B3.m(), LO, B, B->get_shape_item(axis));
 }
 //----------------------------------------------------------------------------
+Value_P
+Bif_REDUCE::reduce_packed(Function_P LO, const uint64_t * bits,
+                          const Shape & shape_Z, const Shape3 & B3)
+{
+enum { RED_PLUS, RED_AND, RED_OR, RED_UNEQU, RED_EQUAL } red;
+   if      (LO == Bif_F12_PLUS::fun)   red = RED_PLUS;
+   else if (LO == Bif_F2_AND::fun)     red = RED_AND;
+   else if (LO == Bif_F2_OR::fun)      red = RED_OR;
+   else if (LO == Bif_F2_UNEQU::fun)   red = RED_UNEQU;
+   else if (LO == Bif_F2_EQUAL::fun)   red = RED_EQUAL;
+   else                                return Value_P();
+
+const ShapeItem len_M = B3.m();
+Value_P Z(shape_Z, LOC);
+   loop(h, B3.h())
+   loop(l, B3.l())
+      {
+        // count the 1-bits in B[h;;l]
+        //
+        ShapeItem count = 0;
+        if (B3.l() == 1)   // contiguous bits
+           {
+             count = Value::count_packed_bits(bits, h*len_M, len_M);
+           }
+        else
+           {
+             loop(m, len_M)
+                {
+                  const ShapeItem b = B3.hml(h, m, l);
+                  count += (bits[b >> 6] >> (b & 63)) & 1;
+                }
+           }
+
+        switch(red)
+           {
+             case RED_PLUS:  Z->next_ravel_Int(count);                   break;
+             case RED_AND:   Z->next_ravel_Int(count == len_M);          break;
+             case RED_OR:    Z->next_ravel_Int(count != 0);              break;
+             case RED_UNEQU: Z->next_ravel_Int(count & 1);               break;
+             case RED_EQUAL: Z->next_ravel_Int((count + len_M - 1) & 1); break;
+           }
+      }
+
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
+// typed reduction of simple numeric values...
+
+/// the associative scalar functions with a typed reduction
+enum Reduce_op
+{
+   ROP_NONE,   ///< no typed reduction
+   ROP_ADD,    ///< +/
+   ROP_MUL,    ///< ×/
+   ROP_MAX,    ///< ⌈/
+   ROP_MIN,    ///< ⌊/
+   ROP_AND,    ///< ∧/ (boolean items only)
+   ROP_OR,     ///< ∨/ (boolean items only)
+};
+
+/// how the items of a typed reduction are distributed over the cores
+enum Reduce_mode
+{
+   RMODE_ROWS,      ///< the items are the (H-)rows of B
+   RMODE_COLUMNS,   ///< the items are the (L-)columns of B
+   RMODE_SPLIT,     ///< the items are the blocks of the single beam of B
+};
+
+/// the number of independent accumulators of a contiguous beam. They allow
+/// the compiler to use SIMD registers for the accumulation.
+enum { REDUCE_LANES = 8 };
+
+/// the number of columns that are reduced together (so that the
+/// accumulators of the columns stay in the cache)
+enum { REDUCE_BLOCK = 2048 };
+
+/// the number of items of the single beam that are reduced to one partial
+/// result (RMODE_SPLIT). The blocks do not depend on the cores that compute
+/// them, so that a real +/ or ×/ gives the same result every time.
+enum { REDUCE_SPLIT_BLOCK = 8192 };
+
+/// a typed reduction (the items of B and Z are APL_Integer or APL_Float)
+struct Reduce_job
+{
+   /// the operation
+   Reduce_op op;
+
+   /// the distribution of the items
+   Reduce_mode mode;
+
+   /// true if the items are APL_Floats
+   bool reals;
+
+   /// the ravel of B
+   const void * B;
+
+   /// the ravel of Z
+   void * Z;
+
+   /// the H-, M-, and L-lengths of B
+   ShapeItem len_H, len_M, len_L;
+
+   /// the partial results of RMODE_SPLIT (one per block)
+   void * partials;
+
+   /// non-0 if some core needs the Cell functions (one per core)
+   uint64_t * bad;
+};
+
+/// the current typed reduction
+static Reduce_job reduce_job;
+
+//----------------------------------------------------------------------------
+/// return OP / B[0] ... B[len-1] of a contiguous beam B
+template<typename OP, typename T>
+SIMD_INLINE T
+reduce_beam(const T * B, ShapeItem len, uint64_t & bad)
+{
+   if (len < 2*REDUCE_LANES)   // short beam: reduce from the right
+      {
+        T accu = B[len - 1];
+        for (ShapeItem m = len - 2; m >= 0; --m)
+            accu = OP::fun(B[m], accu, bad);
+        return accu;
+      }
+
+T accu[REDUCE_LANES];
+   loop(j, REDUCE_LANES)   accu[j] = B[j];
+
+ShapeItem m = REDUCE_LANES;
+   for (; m + REDUCE_LANES <= len; m += REDUCE_LANES)
+       loop(j, REDUCE_LANES)   accu[j] = OP::fun(accu[j], B[m + j], bad);
+
+T ret = accu[0];
+   for (int j = 1; j < REDUCE_LANES; ++j)   ret = OP::fun(ret, accu[j], bad);
+   for (; m < len; ++m)   ret = OP::fun(ret, B[m], bad);
+   return ret;
+}
+//----------------------------------------------------------------------------
+/// Z[l] ← OP / B[;l] for the columns l_from ≤ l < l_to of the len_M by len_L
+/// matrix B. The rows of B are streamed from the last to the first, so that
+/// every Z[l] is computed in the same order as by the Cell functions.
+template<typename OP, typename T>
+SIMD_INLINE void
+reduce_columns(T * Z, const T * B, ShapeItem len_M, ShapeItem len_L,
+               ShapeItem l_from, ShapeItem l_to, uint64_t & bad)
+{
+   for (ShapeItem l0 = l_from; l0 < l_to; l0 += REDUCE_BLOCK)
+       {
+         const ShapeItem l1 = (l_to - l0) < REDUCE_BLOCK ? l_to
+                                                          : l0 + REDUCE_BLOCK;
+         const T * row = B + (len_M - 1)*len_L;
+         for (ShapeItem l = l0; l < l1; ++l)   Z[l] = row[l];
+         for (ShapeItem m = len_M - 2; m >= 0; --m)
+             {
+               row -= len_L;
+               for (ShapeItem l = l0; l < l1; ++l)
+                   Z[l] = OP::fun(row[l], Z[l], bad);
+             }
+       }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of \b job on core \b core
+template<typename OP, typename T>
+SIMD_INLINE void
+reduce_items(const Reduce_job & job, ShapeItem from, ShapeItem to,
+             CoreNumber core)
+{
+const T * B = reinterpret_cast<const T *>(job.B);
+T * Z = reinterpret_cast<T *>(job.Z);
+const ShapeItem len_ML = job.len_M * job.len_L;
+uint64_t bad = 0;
+
+   switch(job.mode)
+      {
+        case RMODE_ROWS:
+             for (ShapeItem h = from; h < to; ++h)
+                 {
+                   if (job.len_L == 1)
+                      Z[h] = reduce_beam<OP>(B + h*job.len_M, job.len_M, bad);
+                   else
+                      reduce_columns<OP>(Z + h*job.len_L, B + h*len_ML,
+                                         job.len_M, job.len_L, 0, job.len_L,
+                                         bad);
+                 }
+             break;
+
+        case RMODE_COLUMNS:
+             loop(h, job.len_H)
+                 reduce_columns<OP>(Z + h*job.len_L, B + h*len_ML,
+                                    job.len_M, job.len_L, from, to, bad);
+             break;
+
+        case RMODE_SPLIT:
+             for (ShapeItem b = from; b < to; ++b)
+                 {
+                   const ShapeItem m = b*REDUCE_SPLIT_BLOCK;
+                   const ShapeItem rest = job.len_M - m;
+                   reinterpret_cast<T *>(job.partials)[b] =
+                      reduce_beam<OP>(B + m, rest < REDUCE_SPLIT_BLOCK
+                                           ? rest : REDUCE_SPLIT_BLOCK, bad);
+                 }
+             break;
+      }
+
+   job.bad[core] |= bad;
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of the integer reduction \b job
+SIMD_KERNEL static void
+int_reduce(const Reduce_job & job, ShapeItem from, ShapeItem to,
+           CoreNumber core)
+{
+   switch(job.op)
+      {
+        case ROP_ADD: reduce_items<Int_add, APL_Integer>(job, from, to, core);
+                      break;
+        case ROP_MUL: reduce_items<Int_mul, APL_Integer>(job, from, to, core);
+                      break;
+        case ROP_MAX: reduce_items<Int_max, APL_Integer>(job, from, to, core);
+                      break;
+        case ROP_MIN: reduce_items<Int_min, APL_Integer>(job, from, to, core);
+                      break;
+        case ROP_AND: reduce_items<Bool_and, APL_Integer>(job, from, to, core);
+                      break;
+        case ROP_OR:  reduce_items<Bool_or, APL_Integer>(job, from, to, core);
+                      break;
+        default:      Assert(0 && "bad integer reduction");
+      }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of the real reduction \b job
+SIMD_KERNEL static void
+float_reduce(const Reduce_job & job, ShapeItem from, ShapeItem to,
+             CoreNumber core)
+{
+   switch(job.op)
+      {
+        case ROP_ADD: reduce_items<Flt_add, APL_Float>(job, from, to, core);
+                      break;
+        case ROP_MUL: reduce_items<Flt_mul, APL_Float>(job, from, to, core);
+                      break;
+        case ROP_MAX: reduce_items<Flt_max, APL_Float>(job, from, to, core);
+                      break;
+        case ROP_MIN: reduce_items<Flt_min, APL_Float>(job, from, to, core);
+                      break;
+        default:      Assert(0 && "bad real reduction");
+      }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of \b job on core \b core
+static void
+do_reduce_items(const Reduce_job & job, ShapeItem from, ShapeItem to,
+                CoreNumber core)
+{
+   if (job.reals)   float_reduce(job, from, to, core);
+   else             int_reduce(job, from, to, core);
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+/// the pool function of a parallel typed reduction
+static void
+PF_reduce_typed(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+         do_reduce_items(reduce_job, from, to, tctx.get_N());
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+Value_P
+Bif_REDUCE::reduce_typed(Function_P LO, const Value & B,
+                         const Shape & shape_Z, const Shape3 & B3)
+{
+Reduce_op op = ROP_NONE;
+   if      (LO == Bif_F12_PLUS::fun)     op = ROP_ADD;
+   else if (LO == Bif_F12_TIMES::fun)    op = ROP_MUL;
+   else if (LO == Bif_F12_RND_UP::fun)   op = ROP_MAX;
+   else if (LO == Bif_F12_RND_DN::fun)   op = ROP_MIN;
+   else if (LO == Bif_F2_AND::fun)       op = ROP_AND;
+   else if (LO == Bif_F2_OR::fun)        op = ROP_OR;
+   else                                  return Value_P();
+
+const ShapeItem len_B = B.element_count();
+   if (len_B < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+PERFORMANCE_START(start)
+
+Kernel_arg arg_B(B);
+   if (arg_B.type == CT_NONE)   return Value_P();
+
+const bool reals = arg_B.type != CT_INT;
+   if (reals && (op == ROP_AND || op == ROP_OR))   return Value_P();
+
+const ShapeItem len_Z = shape_Z.get_volume();
+APL_Integer * ints_Z  = 0;
+APL_Float   * reals_Z = 0;
+   if (reals)   reals_Z = Value::new_typed_ravel<APL_Float>(len_Z, LOC);
+   else         ints_Z  = Value::new_typed_ravel<APL_Integer>(len_Z, LOC);
+
+   reduce_job.op     = op;
+   reduce_job.mode   = RMODE_ROWS;
+   reduce_job.reals  = reals;
+   reduce_job.B      = reals ? static_cast<const void *>(arg_B.get_reals(len_B))
+                             : static_cast<const void *>(arg_B.ints);
+   reduce_job.Z      = reals ? static_cast<void *>(reals_Z)
+                             : static_cast<void *>(ints_Z);
+   reduce_job.len_H  = B3.h();
+   reduce_job.len_M  = B3.m();
+   reduce_job.len_L  = B3.l();
+
+   // per-core results
+   //
+const CoreCount cores = Thread_context::get_active_core_count();
+std::vector<uint64_t> bad(cores, 0);
+   reduce_job.bad = &bad[0];
+
+#if PARALLEL_ENABLED
+   if (Parallel::run_parallel && cores > 1 &&
+       len_B > Bif_OPER1_REDUCE::fun->get_monadic_threshold())
+      {
+        // the partial results of RMODE_SPLIT (one per block)
+        //
+        std::vector<APL_Integer> int_partials;
+        std::vector<APL_Float> real_partials;
+
+        ShapeItem items = B3.h();
+        if (B3.h() < cores && B3.l() > 1)   // too few rows: split the columns
+           {
+             reduce_job.mode = RMODE_COLUMNS;
+             items = B3.l();
+           }
+        else if (B3.h() == 1)               // split the single beam
+           {
+             reduce_job.mode = RMODE_SPLIT;
+             items = (B3.m() + REDUCE_SPLIT_BLOCK - 1) / REDUCE_SPLIT_BLOCK;
+             if (reals)
+                {
+                  real_partials.resize(items);
+                  reduce_job.partials = &real_partials[0];
+                }
+             else
+                {
+                  int_partials.resize(items);
+                  reduce_job.partials = &int_partials[0];
+                }
+           }
+
+        Thread_context::M_distribute_work(items, cores);
+        Thread_context::do_work = PF_reduce_typed;
+        Thread_context::M_fork("reduce_typed");   // start pool
+        PF_reduce_typed(Thread_context::get_master());
+        Thread_context::M_join();
+
+        if (reduce_job.mode == RMODE_SPLIT)   // combine the partials in order
+           {
+             reduce_job.mode  = RMODE_ROWS;
+             reduce_job.B     = reduce_job.partials;
+             reduce_job.len_M = items;
+             do_reduce_items(reduce_job, 0, 1, CNUM_MASTER);
+           }
+      }
+   else
+#endif // PARALLEL_ENABLED
+      {
+        do_reduce_items(reduce_job, 0, B3.h(), CNUM_MASTER);
+      }
+
+uint64_t any_bad = 0;
+   loop(c, cores)   any_bad |= bad[c];
+
+   if (any_bad)   // overflow, non-boolean ∧ or ∨, etc: use the Cell functions
+      {
+        delete[] ints_Z;
+        delete[] reals_Z;
+        return Value_P();
+      }
+
+Value_P Z;
+   if (len_Z >= Value::TYPED_MINIMUM_LENGTH)
+      {
+        if (reals)   Z = Value_P(shape_Z, reals_Z, LOC);
+        else         Z = Value_P(shape_Z, ints_Z, LOC);
+      }
+   else   // short Z: Cell ravel
+      {
+        Z = Value_P(shape_Z, LOC);
+        loop(z, len_Z)
+           {
+             if (reals)   Z->next_ravel_Float(reals_Z[z]);
+             else         Z->next_ravel_Int(ints_Z[z]);
+           }
+        Z->check_value(LOC);
+        delete[] ints_Z;
+        delete[] reals_Z;
+      }
+
+PERFORMANCE_END(fs_OPER1_REDUCE_B, start, len_B)
+
+   return Z;
+}
+//----------------------------------------------------------------------------
 Token
 Bif_REDUCE::reduce_n_wise(Value_P A, Token & tok_LO,
                           Value_P B, uAxis axis) const
@@ -279,7 +707,10 @@ Shape shape_Z(B->get_shape());
 
 const Shape3 Z3(shape_Z, axis);
 const Shape3 B3(B->get_shape(), axis);
-   if (LO->may_push_SI())   // user defined LO
+   if (LO->get_func_ufun())   // defined function LO
+      return reduce_defined(LO, B, shape_Z, Z3, B3.m(), A0);
+
+   if (LO->may_push_SI())   // derived function LO with a defined function
       {
         Value_P A1 = IntScalar(A0 < 0 ?  A0 + 1 : 1 - A0, LOC);
         Value_P vsh_Z(LOC, &shape_Z);
@@ -300,6 +731,184 @@ const Shape3 B3(B->get_shape(), axis);
    return do_reduce(shape_Z, Z3, A0, LO, B, B->get_shape_item(axis));
 }
 //----------------------------------------------------------------------------
+/// LO/B, A LO/B, or LO\B for a defined function LO. Every item of Z is the
+/// reduction of a window of items of B (along the axis) from right to left,
+/// i.e. T←B[last] followed by T←B[previous] LO T. The calls of LO are made
+/// one by one: every call of LO pushes an SI entry, and resume() is called
+/// when it returns.
+class Reduce_EOC : public EOC_handler
+{
+public:
+   /// constructor
+   Reduce_EOC(Function_P _LO, Value_P _B, const Shape & shape_Z,
+              const Shape3 & _Z3, ShapeItem _len_B, ShapeItem _n_wise)
+   : LO(_LO),
+     B(_B),
+     Z(shape_Z, LOC),
+     Z3(_Z3),
+     len_B(_len_B),
+     n_wise(_n_wise),
+     z(0),
+     b(0),
+     step(0),
+     todo(0)
+   {}
+
+   /// call LO until it pushes an SI entry (and then return TOK_SI_PUSHED),
+   /// or until Z is complete (and then return Z)
+   Token run();
+
+   /// overloaded EOC_handler::resume()
+   virtual Token resume(Token & result)
+      { store(result);   return run(); }
+
+   /// overloaded EOC_handler::unmark_all_values()
+   virtual void unmark_all_values() const
+      { B->unmark();   Z->unmark();   if (+T)   T->unmark(); }
+
+protected:
+   /// start the window of item \b z of Z. Return false if the window has
+   /// only one item (which is then the item of Z)
+   bool start_item();
+
+   /// store the \b result of LO (into T or into Z)
+   void store(Token & result);
+
+   /// the (defined) function being reduced
+   const Function_P LO;
+
+   /// the right argument
+   Value_P B;
+
+   /// the result
+   Value_P Z;
+
+   /// the right argument of the next call of LO
+   Value_P T;
+
+   /// the H-, M-, and L-lengths of Z
+   const Shape3 Z3;
+
+   /// the length of the axis of B
+   const ShapeItem len_B;
+
+   /// the window length of A LO/B (negative: reversed), or 0 for LO\B
+   const ShapeItem n_wise;
+
+   /// the current item of Z
+   ShapeItem z;
+
+   /// the ravel position in B of the next left argument of LO
+   ShapeItem b;
+
+   /// the distance between subsequent left arguments of LO
+   ShapeItem step;
+
+   /// the number of calls of LO left for item z
+   ShapeItem todo;
+};
+//----------------------------------------------------------------------------
+bool
+Reduce_EOC::start_item()
+{
+const ShapeItem l = z % Z3.l();
+const ShapeItem m = (z / Z3.l()) % Z3.m();
+const ShapeItem h = z / (Z3.l() * Z3.m());
+const ShapeItem base = h*len_B*Z3.l() + l;
+
+ShapeItem first;   // the position of the first item of the window
+ShapeItem count;   // the number of items in the window
+   step = -Z3.l();
+   if (n_wise == 0)       { first = m;                count = m + 1;    }
+   else if (n_wise > 0)   { first = m + n_wise - 1;   count = n_wise;   }
+   else                   { first = m;                count = -n_wise;
+                            step  = Z3.l();                             }
+
+const Cell & cell_first = B->get_cravel(base + first*Z3.l());
+   if (count == 1)
+      {
+        Z->next_ravel_Cell(cell_first);
+        ++z;
+        return false;
+      }
+
+   T = cell_first.to_value(LOC);
+   b = base + first*Z3.l() + step;
+   todo = count - 1;
+   return true;
+}
+//----------------------------------------------------------------------------
+void
+Reduce_EOC::store(Token & result)
+{
+   if (result.get_Class() != TC_VALUE)
+      {
+        // the MORE text would remain after ⎕EA or ⎕EC had handled the
+        // error, and would then show up with the next (unrelated) error.
+        //
+        if (Workspace::SI_top()->get_safe_execution() == 0)
+           MORE_ERROR() << "the function in LO/B or LO\\B returned no value";
+        VALUE_ERROR;
+      }
+
+   T = result.get_apl_val();
+   if (--todo)   return;
+
+   // T is the item z of Z
+   //
+   if (T->is_simple_scalar())   Z->next_ravel_Cell(T->get_cfirst());
+   else                         Z->next_ravel_Pointer(T.get());
+   T.reset();
+   ++z;
+}
+//----------------------------------------------------------------------------
+Token
+Reduce_EOC::run()
+{
+const ShapeItem len_Z = Z->element_count();
+   for (;;)
+       {
+         if (todo == 0)   // start the next item of Z
+            {
+              if (z == len_Z)   break;
+              if (!start_item())   continue;
+            }
+
+         Value_P LO_A = B->get_cravel(b).to_value(LOC);
+         b += step;
+
+         Token result = LO->eval_AB(LO_A, T);
+         if (result.get_tag() == TOK_SI_PUSHED)   return result;
+         store(result);
+       }
+
+   Z->set_default(*B, LOC);
+   Z->check_value(LOC);
+   return Token(TOK_APL_VALUE1, Z);
+}
+//----------------------------------------------------------------------------
+Token
+Bif_REDUCE::reduce_defined(Function_P LO, Value_P B, const Shape & shape_Z,
+                           const Shape3 & Z3, ShapeItem len_B,
+                           ShapeItem n_wise)
+{
+StateIndicator * si = Workspace::SI_top();
+Reduce_EOC * handler = new Reduce_EOC(LO, B, shape_Z, Z3, len_B, n_wise);
+
+   try
+      {
+        const Token result = handler->run();
+        if (result.get_tag() == TOK_SI_PUSHED)   si->set_eoc_handler(handler);
+        else                                     delete handler;
+        return result;
+      }
+   catch (...)
+      {
+        delete handler;
+        throw;
+      }
+}
+//----------------------------------------------------------------------------
 Token
 Bif_REDUCE::do_reduce(const Shape & shape_Z, const Shape3 & Z3, ShapeItem nwise,
                       Function_P LO, Value_P B, ShapeItem bm)
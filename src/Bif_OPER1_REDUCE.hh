@@ -43,6 +43,24 @@ public:
    /// LO-reduce B along axis.
    static Token reduce(Token & LO, Value_P B, uAxis axis);
 
+   /// compute LO/B (if \b n_wise is the length \b len_B of the axis of B),
+   /// A LO/B (if \b n_wise is A), or LO\B (if \b n_wise is 0) for a
+   /// defined function LO without an APL macro
+   static Token reduce_defined(Function_P LO, Value_P B, const Shape & shape_Z,
+                               const Shape3 & Z3, ShapeItem len_B,
+                               ShapeItem n_wise);
+
+   /// LO-reduce the packed boolean ravel \b bits (of a value with shape B3)
+   /// by counting its 1-bits, or return 0 if LO is not one of + ∧ ∨ ≠ =
+   static Value_P reduce_packed(Function_P LO, const uint64_t * bits,
+                                const Shape & shape_Z, const Shape3 & B3);
+
+   /// LO-reduce the simple numeric value \b B (of shape B3) with the typed
+   /// kernels, or return 0 if LO is not one of + × ⌈ ⌊ ∧ ∨ or if some
+   /// item of Z needs the Cell functions (e.g. on integer overflow)
+   static Value_P reduce_typed(Function_P LO, const Value & B,
+                               const Shape & shape_Z, const Shape3 & B3);
+
 protected:
    /// overloaded Function::may_push_SI()
    virtual bool may_push_SI() const
@@ -63,7 +81,8 @@ class Bif_OPER1_REDUCE : public Bif_REDUCE
 {
 public:
    /// Constructor.
-   Bif_OPER1_REDUCE() : Bif_REDUCE(TOK_OPER1_REDUCE) {}
+   Bif_OPER1_REDUCE() : Bif_REDUCE(TOK_OPER1_REDUCE)
+      { set_monadic_threshold(Performance::thresh_OPER1_REDUCE_B); }
 
    /// Overloaded Function::eval_AB().
    virtual Token eval_AB(Value_P A, Value_P B) const
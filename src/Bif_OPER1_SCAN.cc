@@ -24,6 +24,10 @@
 #include "Bif_OPER1_SCAN.hh"
 #include "LvalCell.hh"
 #include "Macro.hh"
+#include "Parallel.hh"
+#include "ScalarFunction.hh"
+#include "ScalarKernels.hh"
+#include "Thread_context.hh"
 #include "Workspace.hh"
 
 Bif_OPER1_SCAN    Bif_OPER1_SCAN ::_fun;
@@ -122,6 +126,460 @@ ShapeItem inc_2 = 0;              // increment after result m*l items
    Z->check_value(LOC);
    return Token(TOK_APL_VALUE1, Z);
 }
+//============================================================================
+// typed (non-Cell) scans of simple numeric values. Like the typed reductions
+// they give up (so that the caller scans Cell by Cell) in all cases where a
+// Cell function would change the type of an item or raise an error.
+//
+// -\ and ÷\ are computed in O(n) with the alternating identities
+//
+//    (-\B)[m] = (-\B)[m-1] + B[m] resp. (-\B)[m-1] - B[m]  (m even resp. odd)
+//    (÷\B)[m] = (÷\B)[m-1] × B[m] resp. (÷\B)[m-1] ÷ B[m]  (m even resp. odd)
+//
+// instead of reducing every prefix of B.
+//============================================================================
+
+/// the scans that have a typed kernel
+enum Scan_op
+{
+   SOP_NONE,   ///< no typed scan
+   SOP_ADD,    ///< +\ .
+   SOP_SUB,    ///< -\ .
+   SOP_MUL,    ///< ×\ .
+   SOP_DIV,    ///< ÷\ (real items only)
+   SOP_MAX,    ///< ⌈\ .
+   SOP_MIN,    ///< ⌊\ .
+   SOP_AND,    ///< ∧\ (boolean items only)
+   SOP_OR,     ///< ∨\ (boolean items only)
+};
+
+/// how the items of a typed scan are distributed over the cores
+enum Scan_mode
+{
+   SMODE_ROWS,      ///< the items are the (H-)rows of B
+   SMODE_COLUMNS,   ///< the items are the (L-)columns of B
+   SMODE_BLOCKS,    ///< pass 1: scan the blocks of a single beam separately
+   SMODE_CARRIES,   ///< compute the carries into the blocks (master only)
+   SMODE_FINISH,    ///< pass 2: combine the blocks with their carries
+};
+
+/// the number of blocks per core into which a single beam is split
+enum { SCAN_BLOCKS_PER_CORE = 8 };
+
+/// a typed scan (the items of B and Z are APL_Integer or APL_Float)
+struct Scan_job
+{
+   /// the operation
+   Scan_op op;
+
+   /// the distribution of the items
+   Scan_mode mode;
+
+   /// true if the items are APL_Floats
+   bool reals;
+
+   /// the ravel of B
+   const void * B;
+
+   /// the ravel of Z
+   void * Z;
+
+   /// the H-, M-, and L-lengths of B
+   ShapeItem len_H, len_M, len_L;
+
+   /// the length of a block (except the last) of a single beam
+   ShapeItem block_len;
+
+   /// the last item of every block (after SMODE_BLOCKS), or the carry into
+   /// every block (after SMODE_CARRIES)
+   void * carries;
+
+   /// non-0 if some core needs the Cell functions (one per core)
+   uint64_t * bad;
+};
+
+/// the current typed scan
+static Scan_job scan_job;
+
+/// real A × B for the even items of ÷\ B. A 0 in B makes the Cell functions
+/// divide by 0 (or not) depending on the items that follow it.
+struct Flt_mul_div
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { bad |= b == 0.0;
+        return Flt_mul::fun(a, b, bad); }
+};
+
+//----------------------------------------------------------------------------
+/// Z ← OP \ B for a contiguous beam B of length \b len, where OP_ODD
+/// (instead of OP) is used for the odd items of the beam
+template<typename OP, typename OP_ODD, typename T>
+SIMD_INLINE void
+scan_beam(T * Z, const T * B, ShapeItem len, uint64_t & bad)
+{
+T accu = Z[0] = B[0];
+ShapeItem m = 1;
+   for (; m + 1 < len; m += 2)
+       {
+         accu = Z[m]     = OP_ODD::fun(accu, B[m],     bad);
+         accu = Z[m + 1] = OP::fun    (accu, B[m + 1], bad);
+       }
+   if (m < len)   Z[m] = OP_ODD::fun(accu, B[m], bad);
+}
+//----------------------------------------------------------------------------
+/// Z[;l] ← OP \ B[;l] for the columns l_from ≤ l < l_to of the len_M by
+/// len_L matrix B. Every row of Z is computed from the row before it, so
+/// that the inner loop runs over contiguous columns.
+template<typename OP, typename OP_ODD, typename T>
+SIMD_INLINE void
+scan_columns(T * Z, const T * B, ShapeItem len_M, ShapeItem len_L,
+             ShapeItem l_from, ShapeItem l_to, uint64_t & bad)
+{
+   for (ShapeItem l = l_from; l < l_to; ++l)   Z[l] = B[l];
+   for (ShapeItem m = 1; m < len_M; ++m)
+       {
+         const T * prev = Z + (m - 1)*len_L;
+         const T * row_B = B + m*len_L;
+         T * row_Z = Z + m*len_L;
+         if (m & 1)
+            for (ShapeItem l = l_from; l < l_to; ++l)
+                row_Z[l] = OP_ODD::fun(prev[l], row_B[l], bad);
+         else
+            for (ShapeItem l = l_from; l < l_to; ++l)
+                row_Z[l] = OP::fun(prev[l], row_B[l], bad);
+       }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of \b job on core \b core
+template<typename OP, typename OP_ODD, typename T>
+SIMD_INLINE void
+scan_items(const Scan_job & job, ShapeItem from, ShapeItem to,
+           CoreNumber core)
+{
+const T * B = reinterpret_cast<const T *>(job.B);
+T * Z = reinterpret_cast<T *>(job.Z);
+T * carries = reinterpret_cast<T *>(job.carries);
+const ShapeItem len_ML = job.len_M * job.len_L;
+uint64_t bad = 0;
+
+   switch(job.mode)
+      {
+        case SMODE_ROWS:
+             for (ShapeItem h = from; h < to; ++h)
+                 {
+                   if (job.len_L == 1)
+                      scan_beam<OP, OP_ODD>(Z + h*job.len_M, B + h*job.len_M,
+                                            job.len_M, bad);
+                   else
+                      scan_columns<OP, OP_ODD>(Z + h*len_ML, B + h*len_ML,
+                                               job.len_M, job.len_L,
+                                               0, job.len_L, bad);
+                 }
+             break;
+
+        case SMODE_COLUMNS:
+             loop(h, job.len_H)
+                 scan_columns<OP, OP_ODD>(Z + h*len_ML, B + h*len_ML,
+                                          job.len_M, job.len_L, from, to, bad);
+             break;
+
+        case SMODE_BLOCKS:
+             for (ShapeItem k = from; k < to; ++k)
+                 {
+                   const ShapeItem b_from = k*job.block_len;
+                   ShapeItem b_len = job.len_M - b_from;
+                   if (b_len > job.block_len)   b_len = job.block_len;
+                   scan_beam<OP, OP_ODD>(Z + b_from, B + b_from, b_len, bad);
+                   carries[k] = Z[b_from + b_len - 1];
+                 }
+             break;
+
+        case SMODE_CARRIES:   // carries[k] ← Z[k*block_len - 1]
+             {
+               T carry = carries[0];
+               for (ShapeItem k = 1; k < to; ++k)
+                   {
+                     const T last = carries[k];
+                     carries[k] = carry;
+                     carry = (k*job.block_len & 1)
+                           ? OP_ODD::fun(carry, last, bad)
+                           : OP::fun    (carry, last, bad);
+                   }
+             }
+             break;
+
+        case SMODE_FINISH:   // the items of block 0 are final after pass 1
+             for (ShapeItem k = from ? from : 1; k < to; ++k)
+                 {
+                   const ShapeItem b_from = k*job.block_len;
+                   ShapeItem b_len = job.len_M - b_from;
+                   if (b_len > job.block_len)   b_len = job.block_len;
+                   const T carry = carries[k];
+                   T * z = Z + b_from;
+                   if (b_from & 1)
+                      loop(j, b_len)   z[j] = OP_ODD::fun(carry, z[j], bad);
+                   else
+                      loop(j, b_len)   z[j] = OP::fun(carry, z[j], bad);
+                 }
+             break;
+      }
+
+   job.bad[core] |= bad;
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of the integer scan \b job
+SIMD_KERNEL static void
+int_scan(const Scan_job & job, ShapeItem from, ShapeItem to, CoreNumber core)
+{
+   switch(job.op)
+      {
+        case SOP_ADD: scan_items<Int_add, Int_add, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_SUB: scan_items<Int_add, Int_sub, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_MUL: scan_items<Int_mul, Int_mul, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_MAX: scan_items<Int_max, Int_max, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_MIN: scan_items<Int_min, Int_min, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_AND: scan_items<Bool_and, Bool_and, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        case SOP_OR:  scan_items<Bool_or, Bool_or, APL_Integer>
+                                (job, from, to, core);
+                      break;
+        default:      Assert(0 && "bad integer scan");
+      }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of the real scan \b job
+SIMD_KERNEL static void
+float_scan(const Scan_job & job, ShapeItem from, ShapeItem to,
+           CoreNumber core)
+{
+   switch(job.op)
+      {
+        case SOP_ADD: scan_items<Flt_add, Flt_add, APL_Float>
+                                (job, from, to, core);
+                      break;
+        case SOP_SUB: scan_items<Flt_add, Flt_sub, APL_Float>
+                                (job, from, to, core);
+                      break;
+        case SOP_MUL: scan_items<Flt_mul, Flt_mul, APL_Float>
+                                (job, from, to, core);
+                      break;
+        case SOP_DIV: scan_items<Flt_mul_div, Flt_div, APL_Float>
+                                (job, from, to, core);
+                      break;
+        case SOP_MAX: scan_items<Flt_max, Flt_max, APL_Float>
+                                (job, from, to, core);
+                      break;
+        case SOP_MIN: scan_items<Flt_min, Flt_min, APL_Float>
+                                (job, from, to, core);
+                      break;
+        default:      Assert(0 && "bad real scan");
+      }
+}
+//----------------------------------------------------------------------------
+/// compute the items [from, to) of \b job on core \b core
+static void
+do_scan_items(const Scan_job & job, ShapeItem from, ShapeItem to,
+              CoreNumber core)
+{
+   if (job.reals)   float_scan(job, from, to, core);
+   else             int_scan(job, from, to, core);
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+/// the pool function of a parallel typed scan
+static void
+PF_scan_typed(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+         do_scan_items(scan_job, from, to, tctx.get_N());
+}
+//----------------------------------------------------------------------------
+/// compute the \b items of scan_job on \b cores cores
+static void
+parallel_scan(ShapeItem items, CoreCount cores)
+{
+   Thread_context::M_distribute_work(items, cores);
+   Thread_context::do_work = PF_scan_typed;
+   Thread_context::M_fork("scan_typed");   // start pool
+   PF_scan_typed(Thread_context::get_master());
+   Thread_context::M_join();
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+Value_P
+Bif_SCAN::scan_typed(Function_P LO, const Value & B, const Shape3 & B3)
+{
+Scan_op op = SOP_NONE;
+   if      (LO == Bif_F12_PLUS::fun)     op = SOP_ADD;
+   else if (LO == Bif_F12_MINUS::fun)    op = SOP_SUB;
+   else if (LO == Bif_F12_TIMES::fun)    op = SOP_MUL;
+   else if (LO == Bif_F12_DIVIDE::fun)   op = SOP_DIV;
+   else if (LO == Bif_F12_RND_UP::fun)   op = SOP_MAX;
+   else if (LO == Bif_F12_RND_DN::fun)   op = SOP_MIN;
+   else if (LO == Bif_F2_AND::fun)       op = SOP_AND;
+   else if (LO == Bif_F2_OR::fun)        op = SOP_OR;
+   else                                  return Value_P();
+
+const ShapeItem len_B = B.element_count();
+   if (len_B < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+PERFORMANCE_START(start)
+
+Kernel_arg arg_B(B);
+   if (arg_B.type == CT_NONE)   return Value_P();
+
+const bool reals = arg_B.type != CT_INT || op == SOP_DIV;
+   if (reals && (op == SOP_AND || op == SOP_OR))   return Value_P();
+
+APL_Integer * ints_Z  = 0;
+APL_Float   * reals_Z = 0;
+   if (reals)   reals_Z = Value::new_typed_ravel<APL_Float>(len_B, LOC);
+   else         ints_Z  = Value::new_typed_ravel<APL_Integer>(len_B, LOC);
+
+   scan_job.op      = op;
+   scan_job.mode    = SMODE_ROWS;
+   scan_job.reals   = reals;
+   scan_job.B       = reals ? static_cast<const void *>(arg_B.get_reals(len_B))
+                            : static_cast<const void *>(arg_B.ints);
+   scan_job.Z       = reals ? static_cast<void *>(reals_Z)
+                            : static_cast<void *>(ints_Z);
+   scan_job.len_H   = B3.h();
+   scan_job.len_M   = B3.m();
+   scan_job.len_L   = B3.l();
+   scan_job.carries = 0;
+
+   // per-core results
+   //
+const CoreCount cores = Thread_context::get_active_core_count();
+std::vector<uint64_t> bad(cores, 0);
+   scan_job.bad = &bad[0];
+
+#if PARALLEL_ENABLED
+   if (Parallel::run_parallel && cores > 1 &&
+       len_B > Bif_OPER1_SCAN::fun->get_monadic_threshold())
+      {
+        if (B3.h() == 1 && B3.l() == 1)   // a single beam: scan in 2 passes
+           {
+             const ShapeItem max_blocks = cores * SCAN_BLOCKS_PER_CORE;
+             scan_job.block_len = (B3.m() + max_blocks - 1) / max_blocks;
+             const ShapeItem blocks = (B3.m() + scan_job.block_len - 1)
+                                    / scan_job.block_len;
+             std::vector<APL_Integer> int_carries(reals ? 0 : blocks);
+             std::vector<APL_Float> real_carries(reals ? blocks : 0);
+             scan_job.carries = reals ? static_cast<void *>(&real_carries[0])
+                                      : static_cast<void *>(&int_carries[0]);
+
+             scan_job.mode = SMODE_BLOCKS;
+             parallel_scan(blocks, cores);
+
+             scan_job.mode = SMODE_CARRIES;
+             do_scan_items(scan_job, 0, blocks, CNUM_MASTER);
+
+             scan_job.mode = SMODE_FINISH;
+             parallel_scan(blocks, cores);
+           }
+        else if (B3.h() < cores && B3.l() > 1)   // split the columns
+           {
+             scan_job.mode = SMODE_COLUMNS;
+             parallel_scan(B3.l(), cores);
+           }
+        else                                     // split the rows
+           {
+             parallel_scan(B3.h(), cores);
+           }
+      }
+   else
+#endif // PARALLEL_ENABLED
+      {
+        do_scan_items(scan_job, 0, B3.h(), CNUM_MASTER);
+      }
+
+uint64_t any_bad = 0;
+   loop(c, cores)   any_bad |= bad[c];
+
+   if (any_bad)   // overflow, non-boolean ∧ or ∨, etc: use the Cell functions
+      {
+        delete[] ints_Z;
+        delete[] reals_Z;
+        return Value_P();
+      }
+
+Value_P Z;
+   if (reals)   Z = Value_P(B.get_shape(), reals_Z, LOC);
+   else         Z = Value_P(B.get_shape(), ints_Z, LOC);
+
+PERFORMANCE_END(fs_OPER1_SCAN_B, start, len_B)
+
+   return Z;
+}
+//----------------------------------------------------------------------------
+Value_P
+Bif_SCAN::scan_cells(Function_P LO, const Value & B, const Shape3 & B3)
+{
+Function::assoc_f2 fun = LO->get_assoc();
+Function::assoc_f2 fun_odd = fun;
+   if (fun == 0)
+      {
+        if (LO == Bif_F12_MINUS::fun)
+           {
+             fun     = &Cell::bif_add;
+             fun_odd = &Cell::bif_subtract;
+           }
+        else if (LO == Bif_F12_DIVIDE::fun)
+           {
+             // A 0 in B makes some B[j]÷B[j+1]÷... a DOMAIN ERROR (or not)
+             // which the identity would not detect. Let do_reduce() do it.
+             //
+             loop(b, B.element_count())
+                {
+                  const Cell & cell_B = B.get_cravel(b);
+                  if (!cell_B.is_numeric() || cell_B.is_near_zero())
+                     return Value_P();
+                }
+             fun     = &Cell::bif_multiply;
+             fun_odd = &Cell::bif_divide;
+           }
+        else return Value_P();
+      }
+
+const ShapeItem len_L = B3.l();
+Value_P Z(B.get_shape(), LOC);
+ShapeItem b = 0;
+   loop(h, B3.h())
+   loop(m, B3.m())
+   loop(l, len_L)
+       {
+         const Cell & cell_B = B.get_cravel(b++);
+         if (m == 0)   // first item in scanned vector
+            {
+              Z->next_ravel_Cell(cell_B);
+              continue;
+            }
+
+         // subsequent item: Z[h; m; l] ← Z[h; m-1; l] LO B[h; m; l]
+         //
+         const ShapeItem z = Z->get_valid_item_count();
+         Z->next_ravel_0();   // pre-init with 0
+         const ErrorCode ec = (cell_B.*((m & 1) ? fun_odd : fun))
+                                 (&Z->get_wravel(z), &Z->get_cravel(z - len_L));
+         if (ec != E_NO_ERROR)   throw_apl_error(ec, LOC);
+       }
+
+   Z->check_value(LOC);
+   return Z;
+}
 //----------------------------------------------------------------------------
 Token
 Bif_SCAN::scan(Token & tok_LO, Value_P B, uAxis axis) const
@@ -167,12 +625,19 @@ const ShapeItem m_len = B->get_shape_item(axis);
 
 const Shape3 shape_Z3(B->get_shape(), axis);
 
+   if (!LO->may_push_SI())
+      {
+        Value_P Z = scan_typed(LO, *B, shape_Z3);
+        if (!Z && B->is_simple())   Z = scan_cells(LO, *B, shape_Z3);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
 Value_P Z(B->get_shape(), LOC);
 ErrorCode (Cell::*assoc_f2)(Cell *, const Cell *) const = LO->get_assoc();
 
    if (assoc_f2)
       {
-        // LO is an associative primitive scalar function.
+        // LO is an associative primitive scalar function and B is nested.
         //
         const Cell * cB = &B->get_cfirst();
         ShapeItem z = 0;
@@ -206,7 +671,10 @@ ErrorCode (Cell::*assoc_f2)(Cell *, const Cell *) const = LO->get_assoc();
    // non-trivial reduce (len > 1)
    //
 const Shape3 Z3(B->get_shape(), axis);
-   if (LO->may_push_SI())   // user defined LO
+   if (LO->get_func_ufun())   // defined function LO
+      return Bif_REDUCE::reduce_defined(LO, B, B->get_shape(), Z3, Z3.m(), 0);
+
+   if (LO->may_push_SI())   // derived function LO with a defined function
       {
         Value_P X4(4, LOC);
         X4->next_ravel_Int(axis + Workspace::get_IO());
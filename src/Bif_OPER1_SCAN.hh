@@ -40,6 +40,17 @@ protected:
    /// Compute the LO-scan of B.
    Token scan(Token & LO, Value_P B, uAxis axis) const;
 
+   /// LO-scan the simple numeric value \b B (of shape B3) with the typed
+   /// kernels, or return 0 if LO is not one of + - × ÷ ⌈ ⌊ ∧ ∨ or if some
+   /// item of Z needs the Cell functions (e.g. on integer overflow)
+   static Value_P scan_typed(Function_P LO, const Value & B,
+                             const Shape3 & B3);
+
+   /// LO-scan the simple value \b B (of shape B3) Cell by Cell, or return
+   /// 0 if LO is not an associative scalar function or - or ÷
+   static Value_P scan_cells(Function_P LO, const Value & B,
+                             const Shape3 & B3);
+
    /// Compute one scan item and store result in Z.
    static void scan_item(Cell * Z, Function_P LO, const Cell * B,
                          uint32_t m_len, uint32_t l_len);
@@ -52,7 +63,8 @@ class Bif_OPER1_SCAN : public Bif_SCAN
 {
 public:
    /// Constructor.
-   Bif_OPER1_SCAN() : Bif_SCAN(TOK_OPER1_SCAN) {}
+   Bif_OPER1_SCAN() : Bif_SCAN(TOK_OPER1_SCAN)
+      { set_monadic_threshold(Performance::thresh_OPER1_SCAN_B); }
 
    /// Overloaded Function::eval_AB().
    virtual Token eval_AB(Value_P A, Value_P B) const
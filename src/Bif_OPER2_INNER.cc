@@ -18,12 +18,17 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <float.h>
+#include <math.h>
+
 #include "Bif_F12_PARTITION_PICK.hh"
 #include "Bif_F12_TAKE_DROP.hh"
 #include "Bif_OPER2_INNER.hh"
 #include "Bif_OPER1_REDUCE.hh"
+#include "Gemm.hh"
 #include "Macro.hh"
 #include "PointerCell.hh"
+#include "ScalarKernels.hh"
 #include "Workspace.hh"
 
 Bif_OPER2_INNER   Bif_OPER2_INNER::_fun;
@@ -113,6 +118,30 @@ const ShapeItem items_B1 = shape_B1.get_volume();
                        ->eval_ALRB(A, _LO, _RO, B);
       }
 
+   // A +.× B of simple numeric matrices (or vectors) is computed by Gemm,
+   // and A ∨.∧ B, A ≠.∧ B, and A ∧.= B of boolean matrices by BitMatrix.
+   //
+   if (A->get_rank() && B->get_rank() && len_A == len_B && len_A)
+      {
+        const prim_f2 f = LO->get_scalar_f2();
+        const prim_f2 g = RO->get_scalar_f2();
+        Value_P Z;
+        if (f == &Cell::bif_add && g == &Cell::bif_multiply)
+           Z = plus_times(*A, *B, items_A1, len_A, items_B1,
+                          shape_A1 + shape_B1);
+        else if (f == &Cell::bif_or && g == &Cell::bif_and)
+           Z = boolean_product(*A, *B, items_A1, len_A, items_B1,
+                               shape_A1 + shape_B1, BitMatrix::OR_AND);
+        else if (f == &Cell::bif_not_equal && g == &Cell::bif_and)
+           Z = boolean_product(*A, *B, items_A1, len_A, items_B1,
+                               shape_A1 + shape_B1, BitMatrix::XOR_AND);
+        else if (f == &Cell::bif_and && g == &Cell::bif_equal)
+           Z = boolean_product(*A, *B, items_A1, len_A, items_B1,
+                               shape_A1 + shape_B1, BitMatrix::AND_EQUAL);
+
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
 Value_P Z(shape_A1 + shape_B1, LOC);
 
    // an important (and the most likely) special case is LO and RO being scalar
@@ -206,6 +235,184 @@ const bool B_enclosed = B->get_rank() > 1;
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+Value_P
+Bif_OPER2_INNER::plus_times(const Value & A, const Value & B, ShapeItem M,
+                            ShapeItem K, ShapeItem N,
+                            const Shape & shape_Z) const
+{
+Kernel_arg arg_A(A);
+   if (arg_A.type == CT_NONE || arg_A.inc == 0)   return Value_P();
+
+Kernel_arg arg_B(B);
+   if (arg_B.type == CT_NONE || arg_B.inc == 0)   return Value_P();
+
+#ifdef PERFORMANCE_COUNTERS_WANTED
+const uint64_t start_1 = cycle_counter();
+#endif
+
+CoreCount cores = CCNT_1;
+#if PARALLEL_ENABLED
+   if (Parallel::run_parallel && M*N > get_dyadic_threshold())
+      cores = Thread_context::get_active_core_count();
+#endif // PARALLEL_ENABLED
+
+const ShapeItem len_Z = M*N;
+APL_Integer * ints_Z = 0;
+APL_Float * reals_Z = 0;
+   if (arg_A.type == CT_INT && arg_B.type == CT_INT)
+      {
+        // the integer Z is exact if no product and no sum of products can
+        // exceed LARGE_INT. Otherwise the Cell functions decide which items
+        // of Z become reals.
+        //
+        APL_Float max_A = 0.0;
+        APL_Float max_B = 0.0;
+        loop(a, M*K)   max_A = fmax(max_A, fabs(APL_Float(arg_A.ints[a])));
+        loop(b, K*N)   max_B = fmax(max_B, fabs(APL_Float(arg_B.ints[b])));
+        if (!(max_A * max_B * K < LARGE_INT))   return Value_P();
+
+        ints_Z = Value::new_typed_ravel<APL_Integer>(len_Z, LOC);
+        Gemm::int_product(ints_Z, arg_A.ints, arg_B.ints, M, K, N, cores);
+      }
+   else
+      {
+        const APL_Float * reals_A = arg_A.get_reals(M*K);
+        const APL_Float * reals_B = arg_B.get_reals(K*N);
+        reals_Z = Value::new_typed_ravel<APL_Float>(len_Z, LOC);
+        Gemm::real_product(reals_Z, reals_A, reals_B, M, K, N, cores);
+
+        // let the Cell functions report overflows
+        //
+        loop(z, len_Z)
+           {
+             if (!(fabs(reals_Z[z]) <= DBL_MAX))
+                {
+                  delete[] reals_Z;
+                  return Value_P();
+                }
+           }
+      }
+
+#ifdef PERFORMANCE_COUNTERS_WANTED
+const uint64_t end_1 = cycle_counter();
+   Performance::fs_OPER2_INNER_AB.add_sample(end_1 - start_1, len_Z);
+#endif
+
+   if (len_Z >= Value::TYPED_MINIMUM_LENGTH)
+      {
+        if (ints_Z)   return Value_P(shape_Z, ints_Z, LOC);
+        return Value_P(shape_Z, reals_Z, LOC);
+      }
+
+Value_P Z(shape_Z, LOC);
+   if (ints_Z)   loop(z, len_Z)   Z->next_ravel_Int(ints_Z[z]);
+   else          loop(z, len_Z)   Z->next_ravel_Float(reals_Z[z]);
+   delete[] ints_Z;
+   delete[] reals_Z;
+
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
+uint64_t *
+Bif_OPER2_INNER::boolean_bits(const Value & V)
+{
+const ShapeItem len = V.element_count();
+const ShapeItem words = (len + 63) >> 6;
+uint64_t * bits = Value::new_typed_ravel<uint64_t>(words, LOC);
+
+   if (const uint64_t * packed = V.get_packed_ravel())
+      {
+        loop(w, words)   bits[w] = packed[w];
+        return bits;
+      }
+
+   loop(w, words)   bits[w] = 0;
+
+   if (const APL_Integer * ints = V.get_int_ravel())
+      {
+        loop(v, len)
+           {
+             if (ints[v] & ~APL_Integer(1))   { delete[] bits;   return 0; }
+             if (ints[v])   bits[v >> 6] |= uint64_t(1) << (v & 63);
+           }
+        return bits;
+      }
+
+   if (V.is_typed())   { delete[] bits;   return 0; }   // reals or chars
+
+   loop(v, len)
+      {
+        const Cell & cell = V.get_cravel(v);
+        if (!cell.is_integer_cell() || (cell.get_int_value() & ~APL_Integer(1)))
+           {
+             delete[] bits;
+             return 0;
+           }
+        if (cell.get_int_value())   bits[v >> 6] |= uint64_t(1) << (v & 63);
+      }
+
+   return bits;
+}
+//----------------------------------------------------------------------------
+Value_P
+Bif_OPER2_INNER::boolean_product(const Value & A, const Value & B,
+                                 ShapeItem M, ShapeItem K, ShapeItem N,
+                                 const Shape & shape_Z,
+                                 BitMatrix::Product prod) const
+{
+uint64_t * bits_A = boolean_bits(A);
+   if (bits_A == 0)   return Value_P();
+
+uint64_t * bits_B = 0;
+   try           { bits_B = boolean_bits(B); }
+   catch (...)   { delete[] bits_A;   throw; }
+   if (bits_B == 0)   { delete[] bits_A;   return Value_P(); }
+
+#ifdef PERFORMANCE_COUNTERS_WANTED
+const uint64_t start_1 = cycle_counter();
+#endif
+
+CoreCount cores = CCNT_1;
+#if PARALLEL_ENABLED
+   if (Parallel::run_parallel && M*N > get_dyadic_threshold())
+      cores = Thread_context::get_active_core_count();
+#endif // PARALLEL_ENABLED
+
+const ShapeItem len_Z = M*N;
+uint64_t * bits_Z = 0;
+   try
+      {
+        bits_Z = Value::new_typed_ravel<uint64_t>((len_Z + 63) >> 6, LOC);
+        BitMatrix::product(bits_Z, bits_A, bits_B, M, K, N, prod, cores);
+      }
+   catch (...)
+      {
+        delete[] bits_A;
+        delete[] bits_B;
+        delete[] bits_Z;
+        throw;
+      }
+
+   delete[] bits_A;
+   delete[] bits_B;
+
+#ifdef PERFORMANCE_COUNTERS_WANTED
+const uint64_t end_1 = cycle_counter();
+   Performance::fs_OPER2_INNER_AB.add_sample(end_1 - start_1, len_Z);
+#endif
+
+   if (len_Z >= Value::TYPED_MINIMUM_LENGTH)
+      return Value_P(shape_Z, bits_Z, LOC);
+
+Value_P Z(shape_Z, LOC);
+   loop(z, len_Z)   Z->next_ravel_Int((bits_Z[z >> 6] >> (z & 63)) & 1);
+   delete[] bits_Z;
+
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
 void
 Bif_OPER2_INNER::scalar_inner_product() const
 {
@@ -223,6 +430,7 @@ const uint64_t start_1 = cycle_counter();
       && job.ZAh * job.ZBl > get_dyadic_threshold())
       {
         job.cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute_work(job.ZAh * job.ZBl, job.cores);
         Thread_context::do_work = PF_scalar_inner_product;
         Thread_context::M_fork("scalar_inner_product");   // start pool
         PF_scalar_inner_product(Thread_context::get_master());
@@ -232,6 +440,7 @@ const uint64_t start_1 = cycle_counter();
 #endif // PARALLEL_ENABLED
       {
         job.cores = CCNT_1;
+        Thread_context::M_distribute_work(job.ZAh * job.ZBl, job.cores);
         PF_scalar_inner_product(Thread_context::get_master());
       }
 
@@ -244,13 +453,8 @@ const uint64_t end_1 = cycle_counter();
 void
 Bif_OPER2_INNER::PF_scalar_inner_product(Thread_context & tctx)
 {
-const ShapeItem Z_len = job.ZAh * job.ZBl;
-
-const ShapeItem slice_len = (Z_len + job.cores - 1)/job.cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > Z_len)   end_z = Z_len;
-
+ShapeItem z, end_z;
+   while (tctx.PF_next_chunk(z, end_z))
    for (; z < end_z; ++z)
        {
         const ShapeItem zah = z/job.ZBl;         // z row = A row
@@ -21,6 +21,7 @@
 #ifndef __BIF_OPER2_INNER_HH_DEFINED__
 #define __BIF_OPER2_INNER_HH_DEFINED__
 
+#include "BitMatrix.hh"
 #include "PrimitiveOperator.hh"
 
 //----------------------------------------------------------------------------
@@ -67,6 +68,21 @@ protected:
    /// inner product for scalar LO and RO
    inline void scalar_inner_product() const;
 
+   /// return A +.× B for the \b M × \b K items of A and the \b K × \b N
+   /// items of B if they are all integers or all reals, or else 0
+   Value_P plus_times(const Value & A, const Value & B, ShapeItem M,
+                      ShapeItem K, ShapeItem N, const Shape & shape_Z) const;
+
+   /// return the inner product \b prod of the \b M × \b K items of A and
+   /// the \b K × \b N items of B if they are all boolean, or else 0
+   Value_P boolean_product(const Value & A, const Value & B, ShapeItem M,
+                           ShapeItem K, ShapeItem N, const Shape & shape_Z,
+                           BitMatrix::Product prod) const;
+
+   /// return the items of \b V as (new[]'ed) packed bits if they are all
+   /// boolean, or else 0
+   static uint64_t * boolean_bits(const Value & V);
+
    /// the main loop for an inner product with scalar functions
    static void PF_scalar_inner_product(Thread_context & tctx);
 
@@ -157,6 +157,7 @@ const uint64_t start_1 = cycle_counter();
       && job.ZAh * job.ZBl > get_dyadic_threshold())
       {
         job.cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute_work(job.ZAh * job.ZBl, job.cores);
         Thread_context::do_work = PF_scalar_outer_product;
         Thread_context::M_fork("scalar_outer_product");   // start pool
         PF_scalar_outer_product(Thread_context::get_master());
@@ -166,6 +167,7 @@ const uint64_t start_1 = cycle_counter();
 #endif // PARALLEL_ENABLED
       {
         job.cores = CCNT_1;
+        Thread_context::M_distribute_work(job.ZAh * job.ZBl, job.cores);
         PF_scalar_outer_product(Thread_context::get_master());
       }
 
@@ -179,13 +181,8 @@ const uint64_t end_1 = cycle_counter();
 void
 Bif_OPER2_OUTER::PF_scalar_outer_product(Thread_context & tctx)
 {
-const ShapeItem Z_len = job.ZAh * job.ZBl;
-
-const ShapeItem slice_len = (Z_len + job.cores - 1)/job.cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > Z_len)   end_z = Z_len;
-
+ShapeItem z, end_z;
+   while (tctx.PF_next_chunk(z, end_z))
    for (; z < end_z; ++z)
        {
         const ShapeItem zah = z/job.ZBl;
@@ -18,11 +18,13 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "Bif_F12_PARTITION_PICK.hh"
 #include "Bif_F12_TAKE_DROP.hh"
 #include "Bif_OPER2_RANK.hh"
 #include "IntCell.hh"
 #include "Macro.hh"
 #include "PointerCell.hh"
+#include "Quad_CR.hh"
 #include "Workspace.hh"
 
 Bif_OPER2_RANK   Bif_OPER2_RANK::_fun;
@@ -80,6 +82,22 @@ const Shape shape_Z = B->get_shape().high_shape(B->get_rank() - rank_chunk_B);
 
 const Shape shape_B = B->get_shape().low_shape(rank_chunk_B);
 
+   if (!LO->may_push_SI())   // primitive LO: call it directly
+      {
+        const ShapeItem len_Z = shape_Z.get_volume();
+        Value_P Z1(shape_Z, LOC);   // the (enclosed) results of LO
+        loop(z, len_Z)
+           {
+             Value_P LO_B = chunk(*B, shape_B, z);
+             Token result = LO->eval_B(LO_B);
+             if (result.get_Class() != TC_VALUE)   return result;   // error
+
+             enclose_result(*Z1, result.get_apl_val());
+           }
+        Z1->check_value(LOC);
+        return conform_results(X, Z1);
+      }
+
 Value_P vsh_B(shape_B.get_rank(), LOC);
    vsh_B->set_proto_Int();   // prototype
    loop(sh, shape_B.get_rank())
@@ -183,6 +201,25 @@ const Shape shape_Z = rk_B_frame ? B->get_shape().high_shape(rk_B_frame)
 const Shape low_A = A->get_shape().low_shape(rank_chunk_A);
 const Shape low_B = B->get_shape().low_shape(rank_chunk_B);
 
+   if (!LO->may_push_SI())   // primitive LO: call it directly
+      {
+        // a scalar frame (of A or B) is the same chunk for all items of Z
+        //
+        const ShapeItem len_Z = shape_Z.get_volume();
+        Value_P Z1(shape_Z, LOC);   // the (enclosed) results of LO
+        loop(z, len_Z)
+           {
+             Value_P LO_A = chunk(*A, low_A, rk_A_frame ? z : 0);
+             Value_P LO_B = chunk(*B, low_B, rk_B_frame ? z : 0);
+             Token result = LO->eval_AB(LO_A, LO_B);
+             if (result.get_Class() != TC_VALUE)   return result;   // error
+
+             enclose_result(*Z1, result.get_apl_val());
+           }
+        Z1->check_value(LOC);
+        return conform_results(X, Z1);
+      }
+
 Value_P vsh_A(LOC, &low_A);
 Value_P vsh_B(LOC, &low_B);
 Value_P vsh_Z(LOC, &shape_Z);
@@ -202,6 +239,62 @@ Value_P X7(7, LOC);
                            ->eval_ALXB(A, _LO, X7, B);
 }
 //----------------------------------------------------------------------------
+Value_P
+Bif_OPER2_RANK::chunk(const Value & B, const Shape & shape_chunk, ShapeItem c)
+{
+const ShapeItem len = shape_chunk.get_volume();
+const ShapeItem from = c*len;
+
+   // copy typed ravels without constructing Cells
+   //
+   if (len >= Value::TYPED_MINIMUM_LENGTH)
+      {
+        if (const APL_Integer * ints_B = B.get_int_ravel())
+           {
+             APL_Integer * ints = Value::new_typed_ravel<APL_Integer>(len, LOC);
+             memcpy(ints, ints_B + from, len*sizeof(APL_Integer));
+             return Value_P(shape_chunk, ints, LOC);
+           }
+
+        if (const APL_Float * reals_B = B.get_float_ravel())
+           {
+             APL_Float * reals = Value::new_typed_ravel<APL_Float>(len, LOC);
+             memcpy(reals, reals_B + from, len*sizeof(APL_Float));
+             return Value_P(shape_chunk, reals, LOC);
+           }
+
+        if (const Unicode * chars_B = B.get_char_ravel())
+           {
+             Unicode * chars = Value::new_typed_ravel<Unicode>(len, LOC);
+             memcpy(chars, chars_B + from, len*sizeof(Unicode));
+             return Value_P(shape_chunk, chars, LOC);
+           }
+      }
+
+Value_P Z(shape_chunk, LOC);
+   loop(l, len)   Z->next_ravel_Cell(B.get_cravel(from + l));
+   Z->set_default(B, LOC);   // empty chunk
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
+void
+Bif_OPER2_RANK::enclose_result(Value & Z1, Value_P result)
+{
+   if (result->is_simple_scalar())
+      Z1.next_ravel_Cell(result->get_cfirst());
+   else
+      Z1.next_ravel_Pointer(result.get());
+}
+//----------------------------------------------------------------------------
+Token
+Bif_OPER2_RANK::conform_results(Value_P X, Value_P Z1)
+{
+   if (!X)   return Token(TOK_APL_VALUE1, Quad_CR::do_CR30(Z1.get()));
+
+   return Bif_F12_PICK::fun->eval_XB(X, Z1);   // ⊃[X] Z1
+}
+//----------------------------------------------------------------------------
 void
 Bif_OPER2_RANK::y123_to_B(Value_P y123, sRank & rank_B)
 {
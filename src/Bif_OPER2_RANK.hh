@@ -68,6 +68,17 @@ protected:
 
    /// convert 1- 2- or 3-element vector y123 to chunk-ranks of A and B
    static void y123_to_AB(Value_P y123, sRank & rk_A, sRank & rk_B);
+
+   /// return the \b c'th chunk (with shape \b shape_chunk) of \b B
+   static Value_P chunk(const Value & B, const Shape & shape_chunk,
+                        ShapeItem c);
+
+   /// append ⊂result to Z1
+   static void enclose_result(Value & Z1, Value_P result);
+
+   /// return ⊃[X] Z1, or 30 ⎕CR Z1 if there is no X (as the macros
+   /// Z__LO_RANK_X5_B and Z__A_LO_RANK_X7_B do)
+   static Token conform_results(Value_P X, Value_P Z1);
 };
 //----------------------------------------------------------------------------
 
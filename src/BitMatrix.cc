@@ -0,0 +1,247 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BitMatrix.hh"
+#include "Value.hh"   // before Thread_context.hh
+#include "Parallel.hh"
+#include "Thread_context.hh"
+
+/// the state of a boolean inner product
+struct BitMatrix_job
+{
+   /// the rows of Z
+   uint64_t * Z_rows;
+
+   /// the rows of A
+   const uint64_t * A_rows;
+
+   /// the rows of B
+   const uint64_t * B_rows;
+
+   /// the number of rows of A and Z
+   ShapeItem M;
+
+   /// the number of columns of A (and of rows of B)
+   ShapeItem K;
+
+   /// the number of words in a row of A
+   ShapeItem words_K;
+
+   /// the number of words in a row of B and Z
+   ShapeItem words_N;
+
+   /// the inner product
+   BitMatrix::Product product;
+};
+
+static BitMatrix_job bit_job;
+
+//----------------------------------------------------------------------------
+/// Z ← Z ∨ B for the \b words words of Z and B
+static SIMD_KERNEL void
+or_words(uint64_t * Z, const uint64_t * B, ShapeItem words)
+{
+   loop(w, words)   Z[w] |= B[w];
+}
+//----------------------------------------------------------------------------
+/// Z ← Z ≠ B for the \b words words of Z and B
+static SIMD_KERNEL void
+xor_words(uint64_t * Z, const uint64_t * B, ShapeItem words)
+{
+   loop(w, words)   Z[w] ^= B[w];
+}
+//----------------------------------------------------------------------------
+/// Z ← Z ∧ B = a for the \b words words of Z and B, where \b flip is 0 if a
+/// is 1 and ~0 if a is 0
+static SIMD_KERNEL void
+and_equal_words(uint64_t * Z, const uint64_t * B, ShapeItem words,
+                uint64_t flip)
+{
+   loop(w, words)   Z[w] &= B[w] ^ flip;
+}
+//----------------------------------------------------------------------------
+/// compute the rows \b from ... \b to - 1 of Z
+static void
+multiply_rows(const BitMatrix_job & job, ShapeItem from, ShapeItem to)
+{
+const ShapeItem words_N = job.words_N;
+   for (ShapeItem w0 = 0; w0 < words_N; w0 += BitMatrix::TILE_WORDS)
+   for (ShapeItem k0 = 0; k0 < job.K;   k0 += BitMatrix::BLOCK_ROWS)
+       {
+         const ShapeItem tw = (words_N - w0 < BitMatrix::TILE_WORDS)
+                            ? words_N - w0 : BitMatrix::TILE_WORDS;
+         const ShapeItem kb = (job.K - k0 < BitMatrix::BLOCK_ROWS)
+                            ? job.K - k0 : BitMatrix::BLOCK_ROWS;
+         for (ShapeItem i = from; i < to; ++i)
+             {
+               uint64_t * Z = job.Z_rows + i*words_N + w0;
+               const uint64_t * A = job.A_rows + i*job.words_K + (k0 >> 6);
+               for (ShapeItem k = 0; k < kb; k += 64)
+                   {
+                     const uint64_t * B = job.B_rows + (k0 + k)*words_N + w0;
+                     uint64_t a = A[k >> 6];
+
+                     if (job.product == BitMatrix::AND_EQUAL)
+                        {
+                          const ShapeItem bits = (kb - k < 64) ? kb - k : 64;
+                          loop(b, bits)
+                             and_equal_words(Z, B + b*words_N, tw,
+                                             ((a >> b) & 1) - 1);
+                          continue;
+                        }
+
+                     // only the rows of B with a 1-bit in A contribute
+                     //
+                     while (a)
+                        {
+                          const int b = __builtin_ctzll(a);
+                          a &= a - 1;
+                          if (job.product == BitMatrix::OR_AND)
+                             or_words(Z, B + b*words_N, tw);
+                          else
+                             xor_words(Z, B + b*words_N, tw);
+                        }
+                   }
+             }
+       }
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+/// the pool function of a parallel boolean inner product
+static void
+PF_bit_matrix(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))   multiply_rows(bit_job, from, to);
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+void
+BitMatrix::split_rows(uint64_t * rows, const uint64_t * bits,
+                      ShapeItem row_count, ShapeItem cols)
+{
+const ShapeItem words = (cols + 63) >> 6;
+const ShapeItem total = (row_count*cols + 63) >> 6;
+
+   loop(r, row_count)
+      {
+        loop(w, words)
+           {
+             const ShapeItem pos = r*cols + (w << 6);
+             const ShapeItem idx = pos >> 6;
+             const int shift = pos & 63;
+             uint64_t word = bits[idx] >> shift;
+             if (shift && idx + 1 < total)   word |= bits[idx + 1] << (64 - shift);
+             *rows++ = word;
+           }
+        rows[-1] &= Value::packed_tail_mask(cols);
+      }
+}
+//----------------------------------------------------------------------------
+void
+BitMatrix::join_rows(uint64_t * bits, const uint64_t * rows,
+                     ShapeItem row_count, ShapeItem cols)
+{
+const ShapeItem words = (cols + 63) >> 6;
+
+   loop(b, (row_count*cols + 63) >> 6)   bits[b] = 0;
+
+ShapeItem pos = 0;
+   loop(r, row_count)
+      {
+        loop(w, words)
+           {
+             const ShapeItem count = (cols - (w << 6) < 64)
+                                   ? cols - (w << 6) : 64;
+             uint64_t word = *rows++;
+             if (count < 64)   word &= (uint64_t(1) << count) - 1;
+
+             const ShapeItem idx = pos >> 6;
+             const int shift = pos & 63;
+             bits[idx] |= word << shift;
+             if (shift && count > 64 - shift)
+                bits[idx + 1] |= word >> (64 - shift);
+             pos += count;
+           }
+      }
+}
+//----------------------------------------------------------------------------
+void
+BitMatrix::product(uint64_t * Z, const uint64_t * A, const uint64_t * B,
+                   ShapeItem M, ShapeItem K, ShapeItem N, Product prod,
+                   CoreCount cores)
+{
+   if (cores > M)   cores = CoreCount(M);
+
+const ShapeItem words_K = (K + 63) >> 6;
+const ShapeItem words_N = (N + 63) >> 6;
+
+uint64_t * A_rows = Value::new_typed_ravel<uint64_t>(M*words_K, LOC);
+uint64_t * B_rows = 0;
+uint64_t * Z_rows = 0;
+   try
+      {
+        B_rows = Value::new_typed_ravel<uint64_t>(K*words_N, LOC);
+        Z_rows = Value::new_typed_ravel<uint64_t>(M*words_N, LOC);
+      }
+   catch (...)
+      {
+        delete[] A_rows;
+        delete[] B_rows;
+        throw;
+      }
+
+   split_rows(A_rows, A, M, K);
+   split_rows(B_rows, B, K, N);
+
+const uint64_t init = (prod == AND_EQUAL) ? ~uint64_t(0) : 0;
+   loop(z, M*words_N)   Z_rows[z] = init;
+
+   bit_job.Z_rows  = Z_rows;
+   bit_job.A_rows  = A_rows;
+   bit_job.B_rows  = B_rows;
+   bit_job.M       = M;
+   bit_job.K       = K;
+   bit_job.words_K = words_K;
+   bit_job.words_N = words_N;
+   bit_job.product = prod;
+
+#if PARALLEL_ENABLED
+   if (cores > 1)
+      {
+        Thread_context::M_distribute_work(M, cores);
+        Thread_context::do_work = PF_bit_matrix;
+        Thread_context::M_fork("bit_matrix");   // start pool
+        PF_bit_matrix(Thread_context::get_master());
+        Thread_context::M_join();
+      }
+   else
+#endif // PARALLEL_ENABLED
+      {
+        multiply_rows(bit_job, 0, M);
+      }
+
+   join_rows(Z, Z_rows, M, N);
+
+   delete[] A_rows;
+   delete[] B_rows;
+   delete[] Z_rows;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __BIT_MATRIX_HH_DEFINED__
+#define __BIT_MATRIX_HH_DEFINED__
+
+#include "Common.hh"
+
+//----------------------------------------------------------------------------
+/// Boolean inner products Z ← A f.g B of a \b M × \b K bit matrix A and a
+/// \b K × \b N bit matrix B. The matrices are stored like packed ravels,
+/// i.e. bit n of a matrix is bit n%64 of word n÷64 (without padding at the
+/// end of a row).
+///
+/// A row of Z is the f-reduction of the rows of B selected (or, for ∧.=,
+/// complemented) by the bits in the corresponding row of A, so that 64
+/// items of Z are computed by a single word operation. The rows of Z are
+/// computed in tiles of TILE_WORDS words and BLOCK_ROWS rows of B so that
+/// the rows of B stay in the caches while they are used. The rows of A
+/// are distributed over the cores.
+class BitMatrix
+{
+public:
+   /// the inner products supported
+   enum Product
+      {
+        OR_AND,      ///< ∨.∧
+        XOR_AND,     ///< ≠.∧
+        AND_EQUAL,   ///< ∧.=
+      };
+
+   /// Z ← A f.g B. The caller has allocated the (M×N + 63) ÷ 64 words of Z.
+   static void product(uint64_t * Z, const uint64_t * A, const uint64_t * B,
+                       ShapeItem M, ShapeItem K, ShapeItem N, Product prod,
+                       CoreCount cores);
+
+   /// the words of a row of Z that are computed together
+   enum { TILE_WORDS = 64 };
+
+   /// the rows of B that are used together (a multiple of 64)
+   enum { BLOCK_ROWS = 512 };
+
+protected:
+   /// copy the \b rows × \b cols bits of a packed matrix into rows that
+   /// start at word boundaries (padded with 0-bits)
+   static void split_rows(uint64_t * rows, const uint64_t * bits,
+                          ShapeItem row_count, ShapeItem cols);
+
+   /// the inverse of split_rows()
+   static void join_rows(uint64_t * bits, const uint64_t * rows,
+                         ShapeItem row_count, ShapeItem cols);
+};
+//----------------------------------------------------------------------------
+
+#endif // __BIT_MATRIX_HH_DEFINED__
@@ -24,6 +24,7 @@
 #include "FloatCell.hh"
 #include "IntCell.hh"
 #include "LvalCell.hh"
+#include "Mergesort.hh"
 #include "Output.hh"
 #include "PointerCell.hh"
 #include "PrintOperator.hh"
@@ -297,7 +298,7 @@ Cell::bif_greater_eq(Cell * Z, const Cell * A) const
 //----------------------------------------------------------------------------
 ShapeItem *
 Cell::sorted_indices(const Cell * ravel, ShapeItem length, Sort_order order,
-                     ShapeItem comp_len)
+                     ShapeItem comp_len, CoreCount cores)
 {
 ShapeItem * indices = new ShapeItem[length];
    if (indices == 0)   return indices;
@@ -307,9 +308,9 @@ ShapeItem * indices = new ShapeItem[length];
 
 const ravel_comp_len ctx = { ravel, comp_len};
    if (order == SORT_ASCENDING)
-      Heapsort<ShapeItem>::sort(indices, length, &ctx, &Cell::greater_cp);
+      Mergesort::sort(indices, length, &ctx, &Cell::greater_cp, cores);
    else
-      Heapsort<ShapeItem>::sort(indices, length, &ctx, &Cell::smaller_cp);
+      Mergesort::sort(indices, length, &ctx, &Cell::smaller_cp, cores);
    return indices;
 }
 //----------------------------------------------------------------------------
@@ -543,8 +543,10 @@ public:
    /// return \b length indices i1, i2, ... iN so that
    /// ravel[i1] < ravel[i2] < ... < ravel[iN]. The indices are 0-based and
    /// the caller must delete[] the result. Returns 0 on error (= WS FULL).
+   /// The indices are sorted on \b cores cores if cores > 1.
    static ShapeItem * sorted_indices(const Cell * ravel, ShapeItem length,
-                                     Sort_order order, ShapeItem comp_len);
+                                     Sort_order order, ShapeItem comp_len,
+                                     CoreCount cores = CCNT_1);
 
    /// the name of \b ct
    static const char * get_cell_type_name(CellType ct);
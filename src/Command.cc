@@ -39,15 +39,18 @@
 #include "Nabla.hh"
 #include "NativeFunction.hh"
 #include "Output.hh"
+#include "Parallel.hh"
 #include "Parser.hh"
 #include "Prefix.hh"
 #include "Quad_FX.hh"
 #include "Quad_TF.hh"
+#include "ScalarFunction.hh"
 #include "Security.hh"
 #include <signal.h>
 #include "StateIndicator.hh"
 #include "Svar_DB.hh"
 #include "Symbol.hh"
+#include "Thread_context.hh"
 #include "Tokenizer.hh"
 #include "UserFunction.hh"
 #include "UserPreferences.hh"
@@ -407,9 +410,23 @@ check_EOC:
 
               Workspace::pop_SI(LOC);
 
-              // we are back in the calling SI. There should be a TOK_SI_PUSHED
-              // token at the top of stack. Replace it with the result from
-              //  the called (just poped) SI.
+              // we are back in the calling SI. If an operator in it waits
+              // for the result of the called (just poped) SI, then let the
+              // operator continue. It may call its function again.
+              //
+              if (Workspace::SI_top()->get_eoc_handler())
+                 {
+                   const Token result =
+                               Workspace::SI_top()->call_eoc_handler(token);
+                   token.~Token();   // free the value (if any)
+                   new (&token) Token(result);
+                   if (token.get_tag() == TOK_SI_PUSHED)   continue;
+                   if (token.get_tag() == TOK_ERROR)       goto check_EOC;
+                 }
+
+              // There should be a TOK_SI_PUSHED token at the top of stack.
+              // Replace it with the result from the called (just poped) SI
+              // (or from the operator).
               //
               {
                 Prefix & prefix =
@@ -1047,6 +1064,188 @@ Command::cmd_KEYB(ostream & out)
 "╚═════════════╩════╩════╩════╩════╩════╩════╩════╩════╩════╩════╩══════════╝\n"
    << endl;
 }
+#if PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+/// return the (minimal) time for computing fun B (if ab is 1) or A fun B
+/// (if ab is 2) with the parallel threshold of \b fun set to \b threshold.
+/// The previous threshold of \b fun is restored, also if fun throws.
+static uint64_t
+pcal_cycles(Function_P fun, int ab, Value_P A, Value_P B, ShapeItem threshold)
+{
+Function * wfun = const_cast<Function *>(fun);
+const ShapeItem old_threshold = (ab == 1) ? fun->get_monadic_threshold()
+                                          : fun->get_dyadic_threshold();
+   if (ab == 1)   wfun->set_monadic_threshold(threshold);
+   else           wfun->set_dyadic_threshold(threshold);
+
+uint64_t best = ~uint64_t(0);
+   try
+      {
+        loop(r, 3)
+           {
+             const uint64_t start = cycle_counter();
+             if (ab == 1)   fun->eval_B(B);
+             else           fun->eval_AB(A, B);
+             const uint64_t cycles = cycle_counter() - start;
+             if (best > cycles)   best = cycles;
+           }
+      }
+   catch (...)
+      {
+        if (ab == 1)   wfun->set_monadic_threshold(old_threshold);
+        else           wfun->set_dyadic_threshold(old_threshold);
+        throw;
+      }
+
+   if (ab == 1)   wfun->set_monadic_threshold(old_threshold);
+   else           wfun->set_dyadic_threshold(old_threshold);
+   return best;
+}
+//----------------------------------------------------------------------------
+/// compute the least-square regression line y = a + b×x for the \b count
+/// points (x[n], y[n]).
+static void
+pcal_regression(const double * x, const double * y, int count,
+                double & a, double & b)
+{
+double sx = 0, sy = 0, sxx = 0, sxy = 0;
+   loop(n, count)
+      {
+        sx  += x[n];          sy  += y[n];
+        sxx += x[n] * x[n];   sxy += x[n] * y[n];
+      }
+
+   b = (count*sxy - sx*sy) / (count*sxx - sx*sx);
+   a = (sy - b*sx) / count;
+}
+//----------------------------------------------------------------------------
+/// measure the sequential and parallel execution times of scalar function
+/// \b fun (monadic if ab is 1, dyadic if ab is 2) for different vector
+/// lengths and set its parallel threshold to the break-even length (see
+/// README-8-parallel).
+static void
+pcal_function(ostream & out, Function_P fun, int ab, const char * name,
+              const char * id)
+{
+   if (dynamic_cast<const ScalarFunction *>(fun) == 0)   return;
+   if (!strcmp(id, "F12_ROLL"))   return;   // would change ⎕RL
+   if (!strcmp(id, "F2_FIND"))    return;   // not computed in parallel
+
+   // the items of A and B. Mixed integers and reals are computed Cell by
+   // Cell (the case where the thresholds matter). The logical functions
+   // other than ⍲ and ⍱ accept (and the bitwise functions need) integers.
+   //
+APL_Integer i1 = 2;
+APL_Float   r2 = 1.5;
+bool        ints = false;
+   if (!strcmp(id, "F2_NAND") || !strcmp(id, "F2_NOR") ||
+       !strcmp(id, "F12_WITHOUT"))
+      { i1 = 0;   ints = true;   r2 = 1; }
+   else if (!strcmp(id, "F2_AND") || !strcmp(id, "F2_OR") ||
+            strstr(id, "_B"))
+      { ints = true;   r2 = 3; }
+
+enum { LENGTHS = 8 };
+double lengths[LENGTHS];
+double cycles_seq[LENGTHS];
+double cycles_par[LENGTHS];
+   loop(l, LENGTHS)
+      {
+        const ShapeItem len = 1000 << l;
+        Value_P B(len, LOC);
+        loop(b, len)
+           {
+             if (b & 1)
+                {
+                  if (ints)   B->next_ravel_Int(r2);
+                  else        B->next_ravel_Float(r2);
+                }
+             else
+                {
+                  B->next_ravel_Int(i1);
+                }
+           }
+        B->check_value(LOC);
+
+        // A ○ B needs an integer A
+        Value_P A = B;
+        if (!strcmp(id, "F12_CIRCLE"))
+           {
+             A = Value_P(len, LOC);
+             loop(a, len)   A->next_ravel_Int(i1);
+             A->check_value(LOC);
+           }
+
+        lengths[l]    = len;
+        cycles_seq[l] = pcal_cycles(fun, ab, A, B, LARGE_INT);
+        cycles_par[l] = pcal_cycles(fun, ab, A, B, 0);
+      }
+
+   // start-up and per-item cycles, sequential (_0) and parallel (_c)
+   //
+double start_0, item_0, start_c, item_c;
+   pcal_regression(lengths, cycles_seq, LENGTHS, start_0, item_0);
+   pcal_regression(lengths, cycles_par, LENGTHS, start_c, item_c);
+
+const UCS_string ucs_name = UCS_string(UTF8_string(name));
+const ShapeItem pad = ucs_name.size() < 10 ? 10 - ucs_name.size() : 1;
+   out << "   " << ucs_name << UCS_string(pad, UNI_SPACE)
+       << "per item: " << setw(6) << int(item_0) << " (sequential) "
+       << setw(6) << int(item_c) << " (parallel)  break-even: ";
+
+   // require a clear gain (10%) since the measurements are not exact
+   //
+ShapeItem threshold;
+   if (item_c < 0.9*item_0)   // parallel is faster for large vectors
+      {
+        const double BE = (start_c - start_0) / (item_0 - item_c);
+        threshold = BE < 0 ? 0 : BE < LARGE_INT ? ShapeItem(BE) : LARGE_INT;
+        out << threshold << endl;
+      }
+   else
+      {
+        threshold = 8888888888888888888ULL;
+        out << "not reached" << endl;
+      }
+
+Function * wfun = const_cast<Function *>(fun);
+   if (ab == 1)   wfun->set_monadic_threshold(threshold);
+   else           wfun->set_dyadic_threshold(threshold);
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+void
+Command::cmd_PCAL(ostream & out, const UCS_string & arg)
+{
+#if PARALLEL_ENABLED
+const int cores = Thread_context::get_active_core_count();
+   if (!Parallel::run_parallel || cores < 2)
+      {
+        out << "Parallel execution is not active (set the number of cores"
+               " used in ⎕SYL first)." << endl;
+        return;
+      }
+
+   out << "Calibrating the parallel thresholds of the scalar functions on "
+       << cores << " cores (cycles)..." << endl
+       << "(the thresholds only apply to arguments that are computed Cell by"
+          " Cell)" << endl;
+
+enum { _B = 1, _AB = 2 };
+#define perfo_1(id, ab, name, _thr)   pcal_function(out, Bif_ ## id::fun, \
+                                                    ab, name, #id);
+#define perfo_2(id, ab, name, thr)   perfo_1(id, ab, name, thr)
+#define perfo_3(id, ab, name, thr)
+#define perfo_4(id, ab, name, thr)
+#include "Performance.def"
+
+   if (arg.starts_iwith("SAVE"))   uprefs.write_threshold_file(out);
+#else
+   out << "\n"
+"Command ]PCAL is not available, since parallel execution was not\n"
+"configured for this APL interpreter (see README-8-parallel)." << endl;
+#endif // PARALLEL_ENABLED
+}
 //----------------------------------------------------------------------------
 void
 Command::cmd_PSTAT(ostream & out, const UCS_string & arg)
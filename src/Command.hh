@@ -167,6 +167,9 @@ protected:
    static void cmd_LOAD(ostream & out, UCS_string_vector & args, 
                         UCS_string & quad_lx, bool silent);
 
+   /// calibrate the parallel thresholds of the scalar functions
+   static void cmd_PCAL(ostream & out, const UCS_string & arg);
+
    /// show performance counters
    static void cmd_PSTAT(ostream & out, const UCS_string & arg);
 
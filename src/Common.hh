@@ -128,6 +128,19 @@ extern UCS_string & MORE_ERROR();   // in Workspace.cc
 
 #define loop(v, e) for (ShapeItem v = 0, __end__ = e; v < __end__; ++v)
 
+/// a function whose loops shall be vectorized. On x86_64 with GCC the
+/// function is compiled twice (for AVX2 and for plain x86_64) and the
+/// proper variant is selected at runtime. Helpers that a SIMD_KERNEL
+/// calls should be SIMD_INLINE so that they are compiled along with it.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+# define SIMD_KERNEL __attribute__((target_clones("avx2", "default"), \
+                                    optimize("tree-vectorize")))
+# define SIMD_INLINE inline __attribute__((always_inline))
+#else
+# define SIMD_KERNEL
+# define SIMD_INLINE inline
+#endif
+
 // #define TROUBLESHOOT_NEW_DELETE
 
 void * common_new(size_t size);
@@ -800,7 +800,7 @@ const APL_Float b = this->dfval();
    if (A->is_float_cell())
       {
          const APL_Float a = A->get_real_value();
-         if (a <= b)   return IntCell::zI(Z, a);
+         if (a <= b)   return FloatCell::zF(Z, a);
          else          return FloatCell::zF(Z, b);
       }
 
@@ -0,0 +1,286 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Gemm.hh"
+#include "Value.hh"   // before Thread_context.hh
+#include "Parallel.hh"
+#include "Thread_context.hh"
+
+/// the state of a matrix product. B has been packed for columns jc ...
+/// jc + nc - 1 and rows pc ... pc + kc - 1; the blocks of MC rows of A are
+/// then packed and multiplied (on different cores).
+struct Gemm_job
+{
+   /// multiply block \b block of A on core \b core
+   void (*do_block)(const Gemm_job & job, ShapeItem block, CoreNumber core);
+
+   /// the ravel of Z
+   void * Z;
+
+   /// the ravel of A
+   const void * A;
+
+   /// the packed block of B
+   const void * B_packed;
+
+   /// the packed blocks of A (one per core)
+   void * A_packed;
+
+   /// the number of rows of A and Z
+   ShapeItem M;
+
+   /// the number of columns of A (and of rows of B)
+   ShapeItem K;
+
+   /// the number of columns of B and Z
+   ShapeItem N;
+
+   /// the first row of the packed block of B
+   ShapeItem pc;
+
+   /// the number of rows of the packed block of B
+   ShapeItem kc;
+
+   /// the first column of the packed block of B
+   ShapeItem jc;
+
+   /// the number of columns of the packed block of B
+   ShapeItem nc;
+};
+
+static Gemm_job gemm_job;
+
+//----------------------------------------------------------------------------
+/// copy the rows \b ic ... ic + mc - 1 and columns \b pc ... pc + kc - 1 of
+/// the \b K columns of \b A into panels of MR rows each. Within a panel the
+/// MR items of a column are adjacent.
+template<typename T>
+static void
+pack_A(T * packed, const T * A, ShapeItem K, ShapeItem ic, ShapeItem mc,
+       ShapeItem pc, ShapeItem kc)
+{
+   for (ShapeItem i = 0; i < mc; i += Gemm::MR)
+       {
+         const ShapeItem mr = (mc - i < Gemm::MR) ? mc - i : Gemm::MR;
+         const T * row = A + (ic + i)*K + pc;
+         loop(k, kc)
+            {
+              loop(r, mr)           packed[r] = row[r*K + k];
+              for (ShapeItem r = mr; r < Gemm::MR; ++r)   packed[r] = 0;
+              packed += Gemm::MR;
+            }
+       }
+}
+//----------------------------------------------------------------------------
+/// copy the rows \b pc ... pc + kc - 1 and columns \b jc ... jc + nc - 1 of
+/// the \b N columns of \b B into panels of NR columns each. Within a panel
+/// the NR items of a row are adjacent.
+template<typename T>
+static void
+pack_B(T * packed, const T * B, ShapeItem N, ShapeItem pc, ShapeItem kc,
+       ShapeItem jc, ShapeItem nc)
+{
+   for (ShapeItem j = 0; j < nc; j += Gemm::NR)
+       {
+         const ShapeItem nr = (nc - j < Gemm::NR) ? nc - j : Gemm::NR;
+         const T * col = B + pc*N + jc + j;
+         loop(k, kc)
+            {
+              loop(c, nr)           packed[c] = col[k*N + c];
+              for (ShapeItem c = nr; c < Gemm::NR; ++c)   packed[c] = 0;
+              packed += Gemm::NR;
+            }
+       }
+}
+//----------------------------------------------------------------------------
+/// compute the (at most) MR × NR items of Z from a panel of A and a panel
+/// of B (of \b kc columns and rows respectively). The items are stored into
+/// Z (with row length \b ldz) if \b first and added to Z otherwise.
+template<typename T>
+static SIMD_INLINE void
+micro_kernel(ShapeItem kc, const T * A, const T * B, T * Z, ShapeItem ldz,
+             ShapeItem mr, ShapeItem nr, bool first)
+{
+T sum[Gemm::MR][Gemm::NR];
+   loop(r, Gemm::MR)   loop(c, Gemm::NR)   sum[r][c] = 0;
+
+   loop(k, kc)
+      {
+        loop(r, Gemm::MR)
+           {
+             const T a = A[r];
+             loop(c, Gemm::NR)   sum[r][c] += a * B[c];
+           }
+        A += Gemm::MR;
+        B += Gemm::NR;
+      }
+
+   if (first)   loop(r, mr)   loop(c, nr)   Z[r*ldz + c]  = sum[r][c];
+   else         loop(r, mr)   loop(c, nr)   Z[r*ldz + c] += sum[r][c];
+}
+//----------------------------------------------------------------------------
+/// micro_kernel() for reals
+static SIMD_KERNEL void
+real_kernel(ShapeItem kc, const APL_Float * A, const APL_Float * B,
+            APL_Float * Z, ShapeItem ldz, ShapeItem mr, ShapeItem nr,
+            bool first)
+{
+   micro_kernel(kc, A, B, Z, ldz, mr, nr, first);
+}
+//----------------------------------------------------------------------------
+/// micro_kernel() for integers
+static SIMD_KERNEL void
+int_kernel(ShapeItem kc, const APL_Integer * A, const APL_Integer * B,
+           APL_Integer * Z, ShapeItem ldz, ShapeItem mr, ShapeItem nr,
+           bool first)
+{
+   micro_kernel(kc, A, B, Z, ldz, mr, nr, first);
+}
+//----------------------------------------------------------------------------
+/// the micro-kernel for T
+static inline void
+kernel(ShapeItem kc, const APL_Float * A, const APL_Float * B, APL_Float * Z,
+       ShapeItem ldz, ShapeItem mr, ShapeItem nr, bool first)
+{
+   real_kernel(kc, A, B, Z, ldz, mr, nr, first);
+}
+
+/// the micro-kernel for T
+static inline void
+kernel(ShapeItem kc, const APL_Integer * A, const APL_Integer * B,
+       APL_Integer * Z, ShapeItem ldz, ShapeItem mr, ShapeItem nr, bool first)
+{
+   int_kernel(kc, A, B, Z, ldz, mr, nr, first);
+}
+//----------------------------------------------------------------------------
+/// pack block \b block (of MC rows) of A and multiply it with the packed
+/// block of B
+template<typename T>
+static void
+do_gemm_block(const Gemm_job & job, ShapeItem block, CoreNumber core)
+{
+const ShapeItem ic = block*Gemm::MC;
+const ShapeItem mc = (job.M - ic < Gemm::MC) ? job.M - ic : Gemm::MC;
+const bool first = job.pc == 0;   // the first block of rows of B
+
+T * A_packed = reinterpret_cast<T *>(job.A_packed) + core*Gemm::MC*Gemm::KC;
+   pack_A(A_packed, reinterpret_cast<const T *>(job.A), job.K, ic, mc,
+          job.pc, job.kc);
+
+const T * B_packed = reinterpret_cast<const T *>(job.B_packed);
+T * Z = reinterpret_cast<T *>(job.Z) + ic*job.N + job.jc;
+   for (ShapeItem j = 0; j < job.nc; j += Gemm::NR)
+       {
+         const ShapeItem nr = (job.nc - j < Gemm::NR) ? job.nc - j : Gemm::NR;
+         const T * B_panel = B_packed + j*job.kc;
+         for (ShapeItem i = 0; i < mc; i += Gemm::MR)
+             {
+               const ShapeItem mr = (mc - i < Gemm::MR) ? mc - i : Gemm::MR;
+               kernel(job.kc, A_packed + i*job.kc, B_panel, Z + i*job.N + j,
+                      job.N, mr, nr, first);
+             }
+       }
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+/// the pool function of a parallel matrix product
+static void
+PF_gemm(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+       {
+         for (ShapeItem block = from; block < to; ++block)
+             (*gemm_job.do_block)(gemm_job, block, tctx.get_N());
+       }
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+/// Z ← A +.× B with items of type T
+template<typename T>
+static void
+gemm_product(T * Z, const T * A, const T * B, ShapeItem M, ShapeItem K,
+             ShapeItem N, CoreCount cores)
+{
+const ShapeItem blocks = (M + Gemm::MC - 1) / Gemm::MC;   // of A
+   if (cores > blocks)   cores = CoreCount(blocks);
+
+   // the packed blocks of B and of A (one per core)
+   //
+const ShapeItem max_kc = (K < Gemm::KC) ? K : Gemm::KC;
+const ShapeItem max_nc = (N < Gemm::NC)
+                       ? (N + Gemm::NR - 1) / Gemm::NR * Gemm::NR : Gemm::NC;
+T * B_packed = Value::new_typed_ravel<T>(max_kc*max_nc, LOC);
+T * A_packed = 0;
+   try { A_packed = Value::new_typed_ravel<T>(cores*Gemm::MC*Gemm::KC, LOC); }
+   catch (...)   { delete[] B_packed;   throw; }
+
+   gemm_job.do_block = &do_gemm_block<T>;
+   gemm_job.Z        = Z;
+   gemm_job.A        = A;
+   gemm_job.B_packed = B_packed;
+   gemm_job.A_packed = A_packed;
+   gemm_job.M        = M;
+   gemm_job.K        = K;
+   gemm_job.N        = N;
+
+   for (ShapeItem jc = 0; jc < N; jc += Gemm::NC)
+   for (ShapeItem pc = 0; pc < K; pc += Gemm::KC)
+       {
+         gemm_job.jc = jc;
+         gemm_job.nc = (N - jc < Gemm::NC) ? N - jc : Gemm::NC;
+         gemm_job.pc = pc;
+         gemm_job.kc = (K - pc < Gemm::KC) ? K - pc : Gemm::KC;
+         pack_B(B_packed, B, N, pc, gemm_job.kc, jc, gemm_job.nc);
+
+#if PARALLEL_ENABLED
+         if (cores > 1)
+            {
+              Thread_context::M_distribute_work(blocks, cores);
+              Thread_context::do_work = PF_gemm;
+              Thread_context::M_fork("gemm");   // start pool
+              PF_gemm(Thread_context::get_master());
+              Thread_context::M_join();
+              continue;
+            }
+#endif // PARALLEL_ENABLED
+
+         loop(block, blocks)   do_gemm_block<T>(gemm_job, block, CNUM_MASTER);
+       }
+
+   delete[] B_packed;
+   delete[] A_packed;
+}
+//----------------------------------------------------------------------------
+void
+Gemm::real_product(APL_Float * Z, const APL_Float * A, const APL_Float * B,
+                   ShapeItem M, ShapeItem K, ShapeItem N, CoreCount cores)
+{
+   gemm_product(Z, A, B, M, K, N, cores);
+}
+//----------------------------------------------------------------------------
+void
+Gemm::int_product(APL_Integer * Z, const APL_Integer * A,
+                  const APL_Integer * B, ShapeItem M, ShapeItem K,
+                  ShapeItem N, CoreCount cores)
+{
+   gemm_product(Z, A, B, M, K, N, cores);
+}
+//----------------------------------------------------------------------------
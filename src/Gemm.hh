@@ -0,0 +1,69 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __GEMM_HH_DEFINED__
+#define __GEMM_HH_DEFINED__
+
+#include "Common.hh"
+
+//----------------------------------------------------------------------------
+/// A cache-blocked matrix product Z ← A +.× B of a \b M × \b K matrix A and
+/// a \b K × \b N matrix B (both in row-major order, like APL ravels).
+///
+/// B is copied (packed) in blocks of KC rows and NC columns, and A in blocks
+/// of MC rows and KC columns, so that the blocks stay in the caches while
+/// they are used. The packed blocks are multiplied by a micro-kernel that
+/// computes MR × NR items of Z in registers. The blocks of A are
+/// distributed over the cores.
+///
+/// Every item of Z is summed in the same order regardless of the number of
+/// cores, so that the result does not depend on it.
+class Gemm
+{
+public:
+   /// Z ← A +.× B for real A and B
+   static void real_product(APL_Float * Z, const APL_Float * A,
+                            const APL_Float * B, ShapeItem M, ShapeItem K,
+                            ShapeItem N, CoreCount cores);
+
+   /// Z ← A +.× B for integer A and B. The caller must ensure that no
+   /// product and no sum overflows.
+   static void int_product(APL_Integer * Z, const APL_Integer * A,
+                           const APL_Integer * B, ShapeItem M, ShapeItem K,
+                           ShapeItem N, CoreCount cores);
+
+   /// the rows of Z computed by the micro-kernel
+   enum { MR = 4 };
+
+   /// the columns of Z computed by the micro-kernel
+   enum { NR = 8 };
+
+   /// the rows of a packed block of A
+   enum { MC = 64 };
+
+   /// the columns of a packed block of A (= rows of a packed block of B)
+   enum { KC = 256 };
+
+   /// the columns of a packed block of B
+   enum { NC = 1024 };
+};
+//----------------------------------------------------------------------------
+
+#endif // __GEMM_HH_DEFINED__
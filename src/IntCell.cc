@@ -505,7 +505,7 @@ IntCell::bif_subtract(Cell * Z, const Cell * A) const
         const APL_Integer z = a - b;
 
         if (diff_overflow(z, a, b))
-           return FloatCell::zF(Z, APL_Float(a) + APL_Float(b));
+           return FloatCell::zF(Z, APL_Float(a) - APL_Float(b));
         else
            return IntCell::zI(Z,z);
       }
@@ -0,0 +1,204 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include <vector>
+
+#include "Mergesort.hh"
+#include "Value.hh"   // before Thread_context.hh
+#include "Parallel.hh"
+#include "Thread_context.hh"
+
+#if PARALLEL_ENABLED
+
+/// what the items of a parallel Mergesort are
+enum Merge_mode
+{
+   MMODE_RUNS,    ///< the items are runs that are sorted
+   MMODE_MERGE,   ///< the items are segments of pairs of runs that are merged
+};
+
+/// the state of a parallel Mergesort
+struct Merge_job
+{
+   /// what to do
+   Merge_mode mode;
+
+   /// the runs to be sorted or merged
+   ShapeItem * from;
+
+   /// the merged runs
+   ShapeItem * to;
+
+   /// the context of gf
+   const void * ctx;
+
+   /// the compare function
+   Mergesort::greater_fun gf;
+
+   /// run r is from[bounds[r]] ... from[bounds[r + 1] - 1]
+   const ShapeItem * bounds;
+
+   /// the number of runs
+   ShapeItem runs;
+
+   /// the number of segments into which each merge is divided
+   ShapeItem segments;
+};
+
+static Merge_job merge_job;
+
+//----------------------------------------------------------------------------
+/// return the number of items of \b L that are among the first \b k items
+/// of the merge of \b L (of length \b len_L) and \b R (of length \b len_R)
+static ShapeItem
+co_rank(const Merge_job & job, ShapeItem k, const ShapeItem * L,
+        ShapeItem len_L, const ShapeItem * R, ShapeItem len_R)
+{
+ShapeItem low  = (k > len_R) ? k - len_R : 0;
+ShapeItem high = (k < len_L) ? k : len_L;
+   while (low < high)
+      {
+        // L[mid] is among the first k items if it comes before R[k - mid - 1]
+        //
+        const ShapeItem mid = (low + high) / 2;
+        if ((*job.gf)(L[mid], R[k - mid - 1], job.ctx))   high = mid;
+        else                                               low = mid + 1;
+      }
+   return low;
+}
+//----------------------------------------------------------------------------
+/// merge segment \b item of \b job
+static void
+do_merge_item(const Merge_job & job, ShapeItem item)
+{
+   if (job.mode == MMODE_RUNS)
+      {
+        const ShapeItem from = job.bounds[item];
+        Heapsort<ShapeItem>::sort(job.from + from, job.bounds[item + 1] - from,
+                                  job.ctx, job.gf);
+        return;
+      }
+
+   // merge segment s of runs L = 2p and R = 2p + 1 (if any)
+   //
+const ShapeItem p = item / job.segments;
+const ShapeItem s = item % job.segments;
+const ShapeItem from_L = job.bounds[2*p];
+const ShapeItem from_R = job.bounds[2*p + 1];
+const ShapeItem end_R  = (2*p + 1 < job.runs) ? job.bounds[2*p + 2] : from_R;
+const ShapeItem * L = job.from + from_L;
+const ShapeItem * R = job.from + from_R;
+const ShapeItem len_L = from_R - from_L;
+const ShapeItem len_R = end_R - from_R;
+
+const ShapeItem k0 = s*(len_L + len_R) / job.segments;
+const ShapeItem k1 = (s + 1)*(len_L + len_R) / job.segments;
+ShapeItem i = co_rank(job, k0, L, len_L, R, len_R);
+ShapeItem j = k0 - i;
+const ShapeItem end_i = co_rank(job, k1, L, len_L, R, len_R);
+const ShapeItem end_j = k1 - end_i;
+
+ShapeItem * Z = job.to + from_L + k0;
+   while (i < end_i && j < end_j)
+      {
+        if ((*job.gf)(L[i], R[j], job.ctx))   *Z++ = R[j++];
+        else                                  *Z++ = L[i++];
+      }
+   while (i < end_i)   *Z++ = L[i++];
+   while (j < end_j)   *Z++ = R[j++];
+}
+//----------------------------------------------------------------------------
+/// the pool function of a parallel Mergesort
+static void
+PF_merge(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+       {
+         for (ShapeItem item = from; item < to; ++item)
+             do_merge_item(merge_job, item);
+       }
+}
+//----------------------------------------------------------------------------
+/// do all \b items of merge_job on \b cores cores
+static void
+parallel_merge(ShapeItem items, CoreCount cores)
+{
+   Thread_context::M_distribute_work(items, cores);
+   Thread_context::do_work = PF_merge;
+   Thread_context::M_fork("merge_sort");   // start pool
+   PF_merge(Thread_context::get_master());
+   Thread_context::M_join();
+}
+#endif // PARALLEL_ENABLED
+//----------------------------------------------------------------------------
+void
+Mergesort::sort(ShapeItem * indices, ShapeItem len, const void * ctx,
+                greater_fun gf, CoreCount cores)
+{
+#if PARALLEL_ENABLED
+   if (cores > 1 && len >= 2*cores)
+      {
+        ShapeItem * buffer = Value::new_typed_ravel<ShapeItem>(len, LOC);
+
+        // one run per core
+        //
+        std::vector<ShapeItem> bounds;
+        loop(r, cores + 1)   bounds.push_back(r*len / cores);
+
+        merge_job.from     = indices;
+        merge_job.to       = buffer;
+        merge_job.ctx      = ctx;
+        merge_job.gf       = gf;
+        merge_job.bounds   = &bounds[0];
+        merge_job.runs     = cores;
+        merge_job.segments = cores;
+        merge_job.mode     = MMODE_RUNS;
+        parallel_merge(merge_job.runs, cores);
+
+        merge_job.mode = MMODE_MERGE;
+        while (merge_job.runs > 1)
+           {
+             const ShapeItem pairs = (merge_job.runs + 1) / 2;
+             parallel_merge(pairs*merge_job.segments, cores);
+
+             // the merged pairs are the runs of the next merge
+             //
+             loop(p, pairs)   bounds[p] = bounds[2*p];
+             bounds[pairs] = len;
+             merge_job.runs = pairs;
+
+             ShapeItem * const from = merge_job.from;
+             merge_job.from = merge_job.to;
+             merge_job.to   = from;
+           }
+
+        if (merge_job.from != indices)
+           memcpy(indices, merge_job.from, len*sizeof(ShapeItem));
+        delete[] buffer;
+        return;
+      }
+#endif // PARALLEL_ENABLED
+
+   Heapsort<ShapeItem>::sort(indices, len, ctx, gf);
+}
+//----------------------------------------------------------------------------
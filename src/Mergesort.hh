@@ -0,0 +1,50 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MERGESORT_HH_DEFINED__
+#define __MERGESORT_HH_DEFINED__
+
+#include "Common.hh"
+#include "Heapsort.hh"
+
+//----------------------------------------------------------------------------
+/// A parallel merge sort of indices (for grades with a compare function).
+///
+/// The indices are divided into one run per core, and the runs are sorted
+/// in parallel with Heapsort. Then pairs of runs are merged until a single
+/// run remains. Every merge is divided into one segment per core, so that
+/// the last merges (of few but long runs) are parallel as well.
+///
+/// The compare function must not consider any two indices equal (the
+/// compare functions of the grades compare the indices if the items are
+/// equal). The result is then the same as that of a Heapsort.
+class Mergesort
+{
+public:
+   /// a function that returns \b true if item \b a is greater than \b b
+   typedef Heapsort<ShapeItem>::greater_fun greater_fun;
+
+   /// sort \b indices (of length \b len) according to \b gf on \b cores cores
+   static void sort(ShapeItem * indices, ShapeItem len, const void * ctx,
+                    greater_fun gf, CoreCount cores);
+};
+//----------------------------------------------------------------------------
+
+#endif // __MERGESORT_HH_DEFINED__
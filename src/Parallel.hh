@@ -176,16 +176,16 @@ using namespace std;
   while (worker-) threads 1 ... are only activated when some parallel work
   is available.
 
-  The worker threads 1... are either working, or busy-waiting for work, or
+  The worker threads 1... are either working, or waiting for work, or
   blocked on a semaphore:
 
          init
           ↓
-       blocked ←→ busy-waiting ←→ working
+       blocked ←→ waiting ←→ working
 
   The transitions
 
-      blocked ←→ busy-waiting
+      blocked ←→ waiting
 
   occur before and after the master thread waits for terminal input or when
   the number of cores is being changed (with ⎕SYL[26;2]). The workers are
@@ -195,11 +195,12 @@ using namespace std;
 
   The transitions
 
-        busy-waiting ←→ working
+        waiting ←→ working
 
   occurs when the execution of APL primitives, primarily scalar functions,
   suggests to execute in parallel (i.e. if the vectors involved are
-  sufficiently long).
+  sufficiently long). A waiting worker spins only briefly and then parks
+  itself (see Thread_context.hh).
 
  **/
 //============================================================================
@@ -344,7 +344,9 @@ public:
 
 #define perfo_3(id, ab, name, thr)                   \
    /** function statistics **/                       \
-   static FunctionStatistics fs_ ## id ## ab;
+   static FunctionStatistics fs_ ## id ## ab;        \
+   /** parallel execution threshold **/              \
+   static const ShapeItem thresh_ ## id ## ab = thr;
 
 #define perfo_4(id, ab, name, thr)                   \
    /** function statistics **/                       \
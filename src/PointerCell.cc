@@ -29,6 +29,7 @@ PointerCell::PointerCell(Value * sub_val, Value & cell_owner)
 {
    Assert(!sub_val->is_simple_scalar());
 
+   sub_val->clear_temp();   // no longer a temporary value
    new (&value.pval.valp) Value_P(sub_val, LOC);
    value.pval.owner = &cell_owner;
 
@@ -45,6 +46,7 @@ PointerCell::PointerCell(Value * sub_val, Value & cell_owner, uint32_t magic)
 
    Assert(magic == 0x6B616769);
 
+   sub_val->clear_temp();   // no longer a temporary value
    new (&value.pval.valp) Value_P(sub_val, LOC);
    value.pval.owner = &cell_owner;
 
@@ -43,6 +43,7 @@
 #include "PointerCell.hh"
 #include "PrimitiveFunction.hh"
 #include "PrintOperator.hh"
+#include "SearchIndex.hh"
 #include "StateIndicator.hh"
 #include "UserFunction.hh"
 #include "Value.hh"
@@ -1121,6 +1122,12 @@ Value_P Z(A->get_shape(), LOC);
         return Token(TOK_APL_VALUE1, Z);
       }
 
+   if (B->element_count() >= 16 && A->element_count() >= 4)
+      {
+        Value_P Z1 = indexed_eval_AB(*A, *B, qct);
+        if (+Z1)   return Token(TOK_APL_VALUE1, Z1);
+      }
+
    for (ConstRavel_P a(A, true); +a; ++a)
        {
          APL_Integer found_a_in_B = 0;
@@ -1139,6 +1146,41 @@ Value_P Z(A->get_shape(), LOC);
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+Value_P
+Bif_F12_ELEMENT::indexed_eval_AB(const Value & A, const Value & B, double qct)
+{
+const SearchIndex & index = B.get_search_cache().get_index();
+   if (!index.is_valid())   return Value_P();
+
+const ShapeItem len_A = A.element_count();
+const ShapeItem len_B = B.element_count();
+
+   // pos[a] < len_B if A[a] is in B
+   //
+ShapeItem * pos = Value::new_typed_ravel<ShapeItem>(len_A, LOC);
+   index.locate_all(A, qct, pos);
+
+   if (len_A < Value::TYPED_MINIMUM_LENGTH)   // short Z: Cell ravel
+      {
+        Value_P Z(A.get_shape(), LOC);
+        loop(a, len_A)   Z->next_ravel_Int(pos[a] < len_B);
+        delete[] pos;
+        Z->check_value(LOC);
+        return Z;
+      }
+
+const ShapeItem words = (len_A + 63) >> 6;
+uint64_t * bits_Z = Value::new_typed_ravel<uint64_t>(words, LOC);
+   loop(w, words)   bits_Z[w] = 0;
+   loop(a, len_A)
+      {
+        if (pos[a] < len_B)   bits_Z[a >> 6] |= uint64_t(1) << (a & 63);
+      }
+   delete[] pos;
+
+   return Value_P(A.get_shape(), bits_Z, LOC);
+}
+//----------------------------------------------------------------------------
 Token
 Bif_F2_INDEX::eval_AB(Value_P A, Value_P B) const
 {
@@ -1540,6 +1582,14 @@ const ShapeItem len_B = B->element_count();
 
 const double qct = Workspace::get_CT();
 
+   // simple B with only integers, only characters, or only reals
+   //
+   if (len_B >= 16)
+      {
+        Value_P Z = SearchIndex::unique(*B, qct);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
    // 1. construct a vector of Cell pointers and sort it so that the
    //    cells being pointed to are sorted ascendingly.
    //
@@ -1617,7 +1667,16 @@ const double qct = Workspace::get_CT();
 
    if (len_A*len_B > 60*60)
       {
-        // large A or B: sort A and B to speed up searches
+        // large A or B: look up A in an index of B if B is simple and has
+        // only integers, only characters, or only reals...
+        //
+        Value_P Z = SearchIndex::select_members(*A, *B, true, qct);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
+   if (len_A*len_B > 60*60)
+      {
+        // ... or else sort A and B to speed up searches
         //
         const Cell ** cells_A = new const Cell *[2*len_A + len_B];
         const Cell ** cells_Z = cells_A + len_A;
@@ -210,6 +210,10 @@ public:
    static Value_P do_eval_B(const Value * B);
 
 protected:
+   /// compute A ∊ B with a SearchIndex of B, or return 0 if B has items
+   /// of different kinds (or nested items)
+   static Value_P indexed_eval_AB(const Value & A, const Value & B,
+                                  double qct);
 };
 //----------------------------------------------------------------------------
 /** primitive functions match and depth */
@@ -1343,7 +1343,13 @@ Value_P Z(shape_Z, LOC);
    loop(b, len_B)
       {
         const Cell & cB = B->get_cravel(b);
-        if (cB.is_pointer_cell())
+        if (cB.is_pointer_cell() &&
+            cB.get_pointer_value()->get_shape() == conformed)   // no padding
+           {
+             const Value & B_sub = *cB.get_pointer_value();
+             loop(zz, conformed_len)   Z->next_ravel_Cell(B_sub.get_cravel(zz));
+           }
+        else if (cB.is_pointer_cell())
            {
              Value_P B_sub = CLONE_P(cB.get_pointer_value(), LOC);
              Shape sh_sub = B_sub->get_shape();
@@ -1788,7 +1794,8 @@ Value_P Z(B->get_shape(), bits, LOC);
 Value_P
 Quad_CR::do_CR41(const Value * B)
 {
-   if (!(B->get_flags() & VF_packed))
+const uint64_t * bits = B->get_packed_ravel();
+   if (bits == 0)
       {
         MORE_ERROR() << "B is not packed in 41 ⎕CR B";
         DOMAIN_ERROR;
@@ -1797,11 +1804,11 @@ Quad_CR::do_CR41(const Value * B)
 Value_P Z(B->get_shape(), LOC);
 
 const ShapeItem B_len = B->element_count();
-const uint8_t * bits = reinterpret_cast<const uint8_t *>(&B->get_cfirst());
 
-   loop(b, B_len)   Z->next_ravel_Int((bits[b >> 3] & 1ULL << (b & 7)) ? 1 : 0);
+   loop(b, B_len)   Z->next_ravel_Int((bits[b >> 6] >> (b & 63)) & 1);
 
-   return Idx0(LOC);
+   Z->check_value(LOC);
+   return Z;
 }
 //----------------------------------------------------------------------------
 
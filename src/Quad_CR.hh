@@ -72,6 +72,9 @@ public:
                                 const UCS_string & var_name,
                                 const Value * value);
 
+   /// compute \b 30 ⎕CR \b B
+   static Value_P do_CR30(const Value * B);
+
    /// compute \b 35 ⎕CR \b B
    static Value_P do_CR35(const Value * B);
 
@@ -134,9 +137,6 @@ protected:
    /// compute \b 27 ⎕CR \b B or \b 28 ⎕CR \b B
    static Value_P do_CR27_28(int A_27_28, const Value * B);
 
-   /// compute \b 30 ⎕CR \b B
-   static Value_P do_CR30(const Value * B);
-
    /// compute \b 31 ⎕CR \b B or \b 32 ⎕CR \b B
    static Value_P do_CR31_32(int A_31_32, const Value * B);
 
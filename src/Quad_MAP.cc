@@ -19,6 +19,7 @@
 */
 
 #include "Quad_MAP.hh"
+#include "SearchIndex.hh"
 #include "Workspace.hh"
 
 Quad_MAP  Quad_MAP::_fun;
@@ -70,37 +71,62 @@ ShapeItem map_len = A->get_rows();               // the number of mappings
              LENGTH_ERROR;
            }
 
-ShapeItem * indices = new ShapeItem[map_len];
-   if (indices == 0)   WS_FULL;
+   // the keys of A are indexed (if they are simple and of the same kind)
+   // or else sorted. The index or the sorted indices are cached with A, so
+   // that only the first A ⎕MAP B with this A builds (and checks) them.
+   //
+SearchCache & cache = A->get_search_cache();
+const double qct = Workspace::get_CT();
+   if (2*map_len == A->element_count())
+      {
+        const SearchIndex & index = cache.get_index(2);   // A[1 3 5 ...]
+        if (index.is_valid())
+           {
+             if (!cache.is_unique(2))
+                {
+                  ShapeItem dup_1, dup_2;
+                  if (index.find_duplicate(qct, dup_1, dup_2))
+                     duplicate_keys(dup_1, dup_2);
+                  cache.set_unique(2);
+                }
 
-   loop(m, map_len)   indices[m] = m;
+             Value_P Z = do_map(*A, &index, 0, B.get(), recursive);
+             return Token(TOK_APL_VALUE1, Z);
+           }
+      }
 
-const ravel_comp_len ctx = { &A->get_cfirst(), 1};
-   Heapsort<ShapeItem>::sort(indices, map_len, &ctx, &Quad_MAP::greater_map);
+const bool checked = cache.has_sorted(&Quad_MAP::greater_map);
+const ShapeItem * indices = cache.get_sorted(map_len, &Quad_MAP::greater_map);
 
    // complain about duplicated keys
    //
-const double qct = Workspace::get_CT();
-   for (ShapeItem m = 1; m < map_len; ++m)
-       {
-          const Cell & cm1 = A->get_cravel(2*indices[m - 1]);
-          const Cell & cm  = A->get_cravel(2*indices[m    ]);
-          if (cm1.equal(cm, qct))
-             {
-               const int qio = Workspace::get_IO();
-               MORE_ERROR() << "Duplicate keys (e.g. A["
-                            << (qio + indices[m - 1]) << "] and A["
-                            << (qio + indices[m]) << "]) in 'A ⎕MAP B'";
-               delete[] indices;
-               DOMAIN_ERROR;
-             }
-       }
+   if (!checked)
+      {
+        for (ShapeItem m = 1; m < map_len; ++m)
+            {
+              const Cell & cm1 = A->get_cravel(2*indices[m - 1]);
+              const Cell & cm  = A->get_cravel(2*indices[m    ]);
+              if (cm1.equal(cm, qct))
+                 {
+                   A->drop_search_cache();   // not checked next time
+                   duplicate_keys(indices[m - 1], indices[m]);
+                 }
+            }
+      }
 
-Value_P Z = do_map(*A, indices, B.get(), recursive);
-   delete[] indices;
+Value_P Z = do_map(*A, 0, indices, B.get(), recursive);
    return Token(TOK_APL_VALUE1, Z);
 }
 //----------------------------------------------------------------------------
+void
+Quad_MAP::duplicate_keys(ShapeItem m1, ShapeItem m2)
+{
+const int qio = Workspace::get_IO();
+   MORE_ERROR() << "Duplicate keys (e.g. A[" << (qio + m1) << "] and A["
+                << (qio + m2) << "]) in 'A ⎕MAP B'";
+   DOMAIN_ERROR;
+}
+//----------------------------------------------------------------------------
 bool
 Quad_MAP::greater_map(const ShapeItem & a, const ShapeItem & b,
                       const void * ctx)
@@ -123,32 +149,87 @@ const Cell * cells_A = rcl->ravel;
    return key.compare(cells_A[2*item]);
 }
 //----------------------------------------------------------------------------
-
-Value_P
-Quad_MAP::do_map(const Value & A, const ShapeItem * sorted_indices_A,
-                 const Value * B, bool recursive)
+ShapeItem
+Quad_MAP::find_key(const Value & A, const SearchIndex * index,
+                   const ShapeItem * sorted_indices_A, ShapeItem map_len,
+                   const Cell & cell_B)
 {
-Value_P Z(B->get_shape(), LOC);         // the result, ⍴Z ←→ ⍴B
+   if (index)
+      {
+        const double qct = Workspace::get_CT();
+        const ShapeItem m = index->find(cell_B, qct);
+        if (m != -1)   return (m < map_len) ? m : -1;
+
+        // the index cannot decide, e.g. for a complex B
+        //
+        loop(k, map_len)   if (cell_B.equal(A.get_cravel(2*k), qct))   return k;
+        return -1;
+      }
 
 const ravel_comp_len ctx = { &A.get_cfirst(),   // start of the ravel
                              1                  // number of chars to compare
                            };
 
+   if (const ShapeItem * map = Heapsort<ShapeItem>::search<const Cell &>
+             (cell_B, sorted_indices_A, map_len, compare_MAP, &ctx))
+      return *map;
+
+   return -1;
+}
+//----------------------------------------------------------------------------
+/// return A ⎕MAP B for integer (or character) keys and values of A and
+/// integers (or characters) B
+template<typename T>
+static Value_P
+map_typed(const T * ravel_A, const SearchIndex & index, ShapeItem map_len,
+          const Value & B, const T * ravel_B)
+{
+const ShapeItem len_B = B.element_count();
+T * ravel_Z = Value::new_typed_ravel<T>(len_B, LOC);
+   loop(b, len_B)
+      {
+        const ShapeItem m = index.find_key(ravel_B[b]);
+        ravel_Z[b] = (m < map_len) ? ravel_A[2*m + 1] : ravel_B[b];
+      }
+
+   return Value_P(B.get_shape(), ravel_Z, LOC);
+}
+//----------------------------------------------------------------------------
+Value_P
+Quad_MAP::do_map(const Value & A, const SearchIndex * index,
+                 const ShapeItem * sorted_indices_A, const Value * B,
+                 bool recursive)
+{
 const ShapeItem len_B = B->element_count();
 const ShapeItem map_len = (A.get_rank() == 1) ? A.element_count() >> 1
                                               : A.get_rows();
+
+   if (index && len_B >= Value::TYPED_MINIMUM_LENGTH)
+      {
+        // mapping e.g. codes or characters: no Cells at all
+        //
+        if (const APL_Integer * ints_A = A.get_int_ravel())
+           {
+             if (const APL_Integer * ints_B = B->get_int_ravel())
+                return map_typed(ints_A, *index, map_len, *B, ints_B);
+           }
+        else if (const Unicode * chars_A = A.get_char_ravel())
+           {
+             if (const Unicode * chars_B = B->get_char_ravel())
+                return map_typed(chars_A, *index, map_len, *B, chars_B);
+           }
+      }
+
+Value_P Z(B->get_shape(), LOC);         // the result, ⍴Z ←→ ⍴B
+
    if (len_B == 0)   // empty value
       {
          const Cell & cell_B = B->get_cfirst();
-         if (const ShapeItem * map =
-                   Heapsort<ShapeItem>::search<const Cell &>
-                                              (cell_B,
-                                               sorted_indices_A,
-                                               map_len,
-                                               compare_MAP,
-                                               &ctx))
+         const ShapeItem map = find_key(A, index, sorted_indices_A, map_len,
+                                        cell_B);
+         if (map != -1)
             {
-              const Cell & cell_A = A.get_cravel(*map*2 + 1);
+              const Cell & cell_A = A.get_cravel(map*2 + 1);
               if (cell_A.is_pointer_cell())
                  {
                    Cell & cell_Z0 = Z->get_wproto();
@@ -171,17 +252,18 @@ const ShapeItem map_len = (A.get_rank() == 1) ? A.element_count() >> 1
    loop(b, len_B)
        {
          const Cell & cell_B = B->get_cravel(b);
-         if (const ShapeItem * map = Heapsort<ShapeItem>::search<const Cell &>
-                   (cell_B, sorted_indices_A, map_len, compare_MAP, &ctx))
+         const ShapeItem map = find_key(A, index, sorted_indices_A, map_len,
+                                        cell_B);
+         if (map != -1)
             {
-             Z->next_ravel_Cell(A.get_cravel(*map*2 + 1));
+             Z->next_ravel_Cell(A.get_cravel(map*2 + 1));
             }
          else   // cell_B shall not be mapped
             {
               if (recursive && cell_B.is_pointer_cell())   // nested: recursive
                  {
                    Value_P sub_B = cell_B.get_pointer_value();
-                   Value_P sub_Z = do_map(A, sorted_indices_A,
+                   Value_P sub_Z = do_map(A, index, sorted_indices_A,
                                           sub_B.get(), true);
                    Z->next_ravel_Pointer(sub_Z.get());
                  }
@@ -23,6 +23,8 @@
 
 #include "QuadFunction.hh"
 
+class SearchIndex;
+
 //----------------------------------------------------------------------------
 /// The implementation of ⎕MAP
 class Quad_MAP : public QuadFunction
@@ -44,9 +46,19 @@ protected:
    static bool greater_map(const ShapeItem & a, const ShapeItem & b,
                            const void * cells);
 
-   /// compute ⎕MAP with (indices of) sorted A
-   static Value_P do_map(const Value & A, const ShapeItem * sorted_indices_A,
-                         const Value * B, bool recursive);
+   /// compute ⎕MAP with the index of the keys of A or else with the
+   /// (indices of) sorted A
+   static Value_P do_map(const Value & A, const SearchIndex * index,
+                         const ShapeItem * sorted_indices_A, const Value * B,
+                         bool recursive);
+
+   /// return the row of A whose key is \b cell_B, or -1 if there is none
+   static ShapeItem find_key(const Value & A, const SearchIndex * index,
+                             const ShapeItem * sorted_indices_A,
+                             ShapeItem map_len, const Cell & cell_B);
+
+   /// throw a DOMAIN ERROR for the equal keys of rows \b m1 and \b m2 of A
+   static void duplicate_keys(ShapeItem m1, ShapeItem m2);
 };
 //----------------------------------------------------------------------------
 
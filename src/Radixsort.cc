@@ -0,0 +1,338 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Value.hh"   // before Thread_context.hh
+#include "Parallel.hh"
+#include "Radixsort.hh"
+#include "Thread_context.hh"
+
+//----------------------------------------------------------------------------
+void
+Radixsort::sort(uint64_t * keys, ShapeItem * items, ShapeItem len,
+                CoreCount cores)
+{
+#if PARALLEL_ENABLED
+   if (cores > 1 && len >= cores*BLOCKS_PER_CORE)
+      {
+        sort_parallel(keys, items, len, cores);
+        return;
+      }
+#endif // PARALLEL_ENABLED
+
+   sort_sequential(keys, items, len);
+}
+//----------------------------------------------------------------------------
+void
+Radixsort::sort_sequential(uint64_t * keys, ShapeItem * items, ShapeItem len)
+{
+   if (len < 2)   return;
+
+   // count the digits of all keys at all digit positions in one pass
+   //
+ShapeItem counts[DIGITS][DIGIT_COUNT];
+   memset(counts, 0, sizeof(counts));
+   loop(j, len)
+      {
+        uint64_t key = keys[j];
+        loop(d, DIGITS)
+           {
+             ++counts[d][key & (DIGIT_COUNT - 1)];
+             key >>= DIGIT_BITS;
+           }
+      }
+
+uint64_t  * keys_2  = 0;   // allocated on demand
+ShapeItem * items_2 = 0;
+uint64_t  * from_keys  = keys;
+ShapeItem * from_items = items;
+
+   loop(d, DIGITS)
+      {
+        ShapeItem * count = counts[d];
+
+        // skip the digit if all keys have the same digit d (which is
+        // typical for the high digits of small integers)
+        //
+        if (count[from_keys[0] >> (d*DIGIT_BITS) & (DIGIT_COUNT - 1)] == len)
+           continue;
+
+        if (keys_2 == 0)
+           {
+             keys_2  = Value::new_typed_ravel<uint64_t>(len, LOC);
+             try { items_2 = Value::new_typed_ravel<ShapeItem>(len, LOC); }
+             catch (...)   { delete[] keys_2;   throw; }
+           }
+
+        // turn the counts into start positions...
+        //
+        ShapeItem pos = 0;
+        loop(c, DIGIT_COUNT)
+           {
+             const ShapeItem cnt = count[c];
+             count[c] = pos;
+             pos += cnt;
+           }
+
+        // ... and distribute the keys and items into the other buffer
+        //
+        uint64_t  * to_keys  = (from_keys == keys) ? keys_2  : keys;
+        ShapeItem * to_items = (from_keys == keys) ? items_2 : items;
+        const int shift = d*DIGIT_BITS;
+        loop(j, len)
+           {
+             const uint64_t key = from_keys[j];
+             const ShapeItem to = count[key >> shift & (DIGIT_COUNT - 1)]++;
+             to_keys[to]  = key;
+             to_items[to] = from_items[j];
+           }
+
+        from_keys  = to_keys;
+        from_items = to_items;
+      }
+
+   if (from_keys != keys)   // odd number of passes: copy back
+      {
+        memcpy(keys,  from_keys,  len*sizeof(uint64_t));
+        memcpy(items, from_items, len*sizeof(ShapeItem));
+      }
+
+   delete[] keys_2;
+   delete[] items_2;
+}
+//----------------------------------------------------------------------------
+#if PARALLEL_ENABLED
+
+/// what the blocks of a parallel Radixsort do
+enum Radix_mode
+{
+   RMODE_COUNT_ALL,   ///< count the digits at all positions
+   RMODE_COUNT,       ///< count the digits at one position
+   RMODE_SCATTER,     ///< distribute keys and items by one digit
+};
+
+/// the state of a parallel Radixsort. The keys and items are divided into
+/// blocks; every block has its own counts (and then start positions) of
+/// the digits so that the blocks can be distributed independently.
+struct Radix_job
+{
+   /// what to do
+   Radix_mode mode;
+
+   /// the digit position (for RMODE_COUNT and RMODE_SCATTER)
+   int digit;
+
+   /// the keys to be distributed
+   const uint64_t * from_keys;
+
+   /// the items to be distributed
+   const ShapeItem * from_items;
+
+   /// the distributed keys
+   uint64_t * to_keys;
+
+   /// the distributed items
+   ShapeItem * to_items;
+
+   /// the number of keys and items
+   ShapeItem len;
+
+   /// the number of keys in a block (except the last one)
+   ShapeItem block_len;
+
+   /// the counts (or start positions) of the digits of the blocks
+   ShapeItem * counts;
+};
+
+static Radix_job radix_job;
+
+/// return the counts of \b digit in \b block
+static inline ShapeItem *
+block_counts(const Radix_job & job, ShapeItem block, int digit)
+{
+   return job.counts + (block*Radixsort::DIGITS + digit)
+                     * Radixsort::DIGIT_COUNT;
+}
+//----------------------------------------------------------------------------
+/// count, or distribute, the keys of \b block of \b job
+static void
+do_radix_block(const Radix_job & job, ShapeItem block)
+{
+const ShapeItem from = block*job.block_len;
+const ShapeItem to = (from + job.block_len < job.len) ? from + job.block_len
+                                                      : job.len;
+   enum { MASK = Radixsort::DIGIT_COUNT - 1 };
+
+   switch(job.mode)
+      {
+        case RMODE_COUNT_ALL:
+             {
+               ShapeItem * count = block_counts(job, block, 0);
+               memset(count, 0, Radixsort::DIGITS * Radixsort::DIGIT_COUNT
+                                * sizeof(ShapeItem));
+               for (ShapeItem j = from; j < to; ++j)
+                   {
+                     uint64_t key = job.from_keys[j];
+                     loop(d, Radixsort::DIGITS)
+                        {
+                          ++count[d*Radixsort::DIGIT_COUNT + (key & MASK)];
+                          key >>= Radixsort::DIGIT_BITS;
+                        }
+                   }
+             }
+             return;
+
+        case RMODE_COUNT:
+             {
+               ShapeItem * count = block_counts(job, block, job.digit);
+               memset(count, 0, Radixsort::DIGIT_COUNT * sizeof(ShapeItem));
+               const int shift = job.digit*Radixsort::DIGIT_BITS;
+               for (ShapeItem j = from; j < to; ++j)
+                   ++count[job.from_keys[j] >> shift & MASK];
+             }
+             return;
+
+        case RMODE_SCATTER:
+             {
+               ShapeItem * pos = block_counts(job, block, job.digit);
+               const int shift = job.digit*Radixsort::DIGIT_BITS;
+               for (ShapeItem j = from; j < to; ++j)
+                   {
+                     const uint64_t key = job.from_keys[j];
+                     const ShapeItem z = pos[key >> shift & MASK]++;
+                     job.to_keys[z]  = key;
+                     job.to_items[z] = job.from_items[j];
+                   }
+             }
+             return;
+      }
+}
+//----------------------------------------------------------------------------
+/// the pool function of a parallel Radixsort
+static void
+PF_radix(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_chunk(from, to))
+       {
+         for (ShapeItem block = from; block < to; ++block)
+             do_radix_block(radix_job, block);
+       }
+}
+//----------------------------------------------------------------------------
+/// do \b mode for all \b blocks of radix_job on \b cores cores
+static void
+parallel_radix(Radix_mode mode, ShapeItem blocks, CoreCount cores)
+{
+   radix_job.mode = mode;
+   Thread_context::M_distribute_work(blocks, cores);
+   Thread_context::do_work = PF_radix;
+   Thread_context::M_fork("radix_sort");   // start pool
+   PF_radix(Thread_context::get_master());
+   Thread_context::M_join();
+}
+//----------------------------------------------------------------------------
+void
+Radixsort::sort_parallel(uint64_t * keys, ShapeItem * items, ShapeItem len,
+                         CoreCount cores)
+{
+const ShapeItem max_blocks = cores*BLOCKS_PER_CORE;
+const ShapeItem block_len = (len + max_blocks - 1) / max_blocks;
+const ShapeItem blocks = (len + block_len - 1) / block_len;
+
+ShapeItem * counts = Value::new_typed_ravel<ShapeItem>(
+                                       blocks*DIGITS*DIGIT_COUNT, LOC);
+uint64_t * keys_2 = 0;
+ShapeItem * items_2 = 0;
+   try
+      {
+        keys_2  = Value::new_typed_ravel<uint64_t>(len, LOC);
+        items_2 = Value::new_typed_ravel<ShapeItem>(len, LOC);
+      }
+   catch (...)
+      {
+        delete[] counts;
+        delete[] keys_2;
+        throw;
+      }
+
+   radix_job.from_keys  = keys;
+   radix_job.from_items = items;
+   radix_job.to_keys    = keys_2;
+   radix_job.to_items   = items_2;
+   radix_job.len        = len;
+   radix_job.block_len  = block_len;
+   radix_job.counts     = counts;
+
+   // count all digits of all blocks (the counts of the first distributed
+   // digit remain valid, the others are only used to skip digits).
+   //
+   parallel_radix(RMODE_COUNT_ALL, blocks, cores);
+
+bool first = true;
+   loop(d, DIGITS)
+      {
+        // skip the digit if all keys have the same digit d
+        //
+        const uint64_t digit_0 = keys[0] >> (d*DIGIT_BITS) & (DIGIT_COUNT - 1);
+        ShapeItem count_0 = 0;
+        loop(b, blocks)   count_0 += block_counts(radix_job, b, d)[digit_0];
+        if (count_0 == len)   continue;
+
+        radix_job.digit = d;
+        if (!first)   parallel_radix(RMODE_COUNT, blocks, cores);
+        first = false;
+
+        // turn the counts into start positions: all blocks with a smaller
+        // digit come first, and then the same digit in the blocks before.
+        //
+        ShapeItem pos = 0;
+        loop(c, DIGIT_COUNT)
+        loop(b, blocks)
+           {
+             ShapeItem & count = block_counts(radix_job, b, d)[c];
+             const ShapeItem cnt = count;
+             count = pos;
+             pos += cnt;
+           }
+
+        parallel_radix(RMODE_SCATTER, blocks, cores);
+
+        // the distributed keys and items are the input of the next digit
+        //
+        const uint64_t * k = radix_job.from_keys;
+        const ShapeItem * i = radix_job.from_items;
+        radix_job.from_keys  = radix_job.to_keys;
+        radix_job.from_items = radix_job.to_items;
+        radix_job.to_keys    = const_cast<uint64_t *>(k);
+        radix_job.to_items   = const_cast<ShapeItem *>(i);
+      }
+
+   if (radix_job.from_keys != keys)   // odd number of passes: copy back
+      {
+        memcpy(keys,  radix_job.from_keys,  len*sizeof(uint64_t));
+        memcpy(items, radix_job.from_items, len*sizeof(ShapeItem));
+      }
+
+   delete[] counts;
+   delete[] keys_2;
+   delete[] items_2;
+}
+//----------------------------------------------------------------------------
+#endif // PARALLEL_ENABLED
@@ -0,0 +1,92 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __RADIXSORT_HH_DEFINED__
+#define __RADIXSORT_HH_DEFINED__
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Common.hh"
+
+//----------------------------------------------------------------------------
+/// A stable LSD (least significant digit first) radix sort of items with
+/// 64-bit keys.
+///
+/// Integers, reals, and characters are mapped to unsigned keys that have
+/// the same order as the values themselves, so that the sort is O(n)
+/// instead of the O(n log n) comparisons (with an indirect function call
+/// each) of Heapsort.
+class Radixsort
+{
+public:
+   /// the sign bit of a 64-bit key
+   static const uint64_t SIGN = 0x8000000000000000ULL;
+
+   /// return the key of integer \b value
+   static uint64_t int_key(APL_Integer value)
+      { return uint64_t(value) ^ SIGN; }
+
+   /// return the key of real \b value. Negative reals are stored as the
+   /// sign and the magnitude, therefore all their bits are flipped, while
+   /// only the sign bit is flipped for positive reals. -0.0 and 0.0 are
+   /// the same key.
+   static uint64_t real_key(APL_Float value)
+      {
+        if (value == 0.0)   value = 0.0;   // -0.0 → 0.0
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & SIGN) ? ~bits : bits | SIGN;
+      }
+
+   /// return the key of character \b uni
+   static uint64_t char_key(Unicode uni)
+      { return int_key(uni); }
+
+   /// sort \b keys ascendingly and permute \b items (of the same length
+   /// \b len) like \b keys. Items with the same key remain in their order.
+   /// The digits are distributed on \b cores cores if cores > 1.
+   static void sort(uint64_t * keys, ShapeItem * items, ShapeItem len,
+                    CoreCount cores = CCNT_1);
+
+   /// bits per digit
+   enum { DIGIT_BITS = 8 };
+
+   /// the number of different digits
+   enum { DIGIT_COUNT = 1 << DIGIT_BITS };
+
+   /// the number of digits in a key
+   enum { DIGITS = 64 / DIGIT_BITS };
+
+   /// the number of blocks per core of a parallel sort
+   enum { BLOCKS_PER_CORE = 4 };
+
+protected:
+   /// sort \b keys and \b items sequentially
+   static void sort_sequential(uint64_t * keys, ShapeItem * items,
+                               ShapeItem len);
+
+   /// sort \b keys and \b items on \b cores cores
+   static void sort_parallel(uint64_t * keys, ShapeItem * items,
+                             ShapeItem len, CoreCount cores);
+};
+//----------------------------------------------------------------------------
+
+#endif // __RADIXSORT_HH_DEFINED__
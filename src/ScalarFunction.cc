@@ -19,6 +19,9 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <float.h>
+#include <math.h>
+
 #include "ArrayIterator.hh"
 #include "Avec.hh"
 #include "CharCell.hh"
@@ -32,9 +35,13 @@
 #include "PointerCell.hh"
 #include "PrintOperator.hh"
 #include "ScalarFunction.hh"
+#include "ScalarKernels.hh"
+#include "SearchIndex.hh"
 #include "Value.hh"
 #include "Workspace.hh"
 
+#include "Cell.icc"
+
 // scalar function instances
 //
 Bif_F2_AND      Bif_F2_AND     ::_fun;                // ∧
@@ -130,6 +137,12 @@ ScalarFunction::eval_scalar_B(Value_P B, prim_f1 fun) const
 const ShapeItem len_Z = B->element_count();
    if (len_Z == 0)   return do_eval_fill_B(B);
 
+   if (get_bool_f1_bool())   // boolean Z: try a packed Z first
+      {
+        Value_P Z = packed_scalar_B(B, fun);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
 PERFORMANCE_START(start)
 
 ErrorCode ec = E_NO_ERROR;
@@ -186,6 +199,9 @@ const bool maybe_parallel = Parallel::run_parallel &&
               //
               job_B->fun = this;
               job_B->fun1 = fun;
+              job_B->value_B->explode();   // before the workers read B
+              Thread_context::M_distribute_work(job_B->len_Z,
+                                       Thread_context::get_active_core_count());
               Thread_context::do_work = PF_scalar_B;
               Thread_context::M_fork("eval_scalar_B");   // start pool
               PF_scalar_B(Thread_context::get_master());
@@ -255,13 +271,8 @@ ScalarFunction::PF_scalar_B(Thread_context & tctx)
       * PointerCell constructors (change their parents)
     */
 
-const int cores = Thread_context::get_active_core_count();
-
-const ShapeItem slice_len = (job_B->len_Z + cores - 1) / cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > job_B->len_Z)   end_z = job_B->len_Z;
-
+ShapeItem z, end_z;
+   while (tctx.PF_next_chunk(z, end_z))
    for (; z < end_z; ++z)
        {
          const Cell & cell_B = job_B->B_at(z);
@@ -344,10 +355,646 @@ ScalarFunction::expand_nested(Value * Z, const Cell * cell_A,
           }
       }
 }
+//============================================================================
+// typed (non-Cell) kernels for dyadic scalar functions on simple numeric
+// values. They produce the same results as the corresponding Cell functions,
+// and give up (so that the caller computes Z Cell by Cell) in all cases where
+// the Cell functions would change the type of an item or raise an error.
+//============================================================================
+
+/// the dyadic scalar functions that have a typed kernel
+enum Kernel_op
+{
+   KOP_NONE,
+   KOP_ADD,   ///< A + B
+   KOP_SUB,   ///< A - B
+   KOP_MUL,   ///< A × B
+   KOP_DIV,   ///< A ÷ B
+   KOP_MAX,   ///< A ⌈ B
+   KOP_MIN,   ///< A ⌊ B
+   KOP_RES,   ///< A ∣ B
+   KOP_EQ,    ///< A = B  (this and all below: comparisons)
+   KOP_NE,    ///< A ≠ B
+   KOP_LT,    ///< A < B
+   KOP_LE,    ///< A ≤ B
+   KOP_GT,    ///< A > B
+   KOP_GE,    ///< A ≥ B
+};
+//----------------------------------------------------------------------------
+/// return the Kernel_op for the Cell function \b fun (if any)
+static Kernel_op
+kernel_op(prim_f2 fun)
+{
+   if (fun == &Cell::bif_add)            return KOP_ADD;
+   if (fun == &Cell::bif_subtract)       return KOP_SUB;
+   if (fun == &Cell::bif_multiply)       return KOP_MUL;
+   if (fun == &Cell::bif_divide)         return KOP_DIV;
+   if (fun == &Cell::bif_maximum)        return KOP_MAX;
+   if (fun == &Cell::bif_minimum)        return KOP_MIN;
+   if (fun == &Cell::bif_residue)        return KOP_RES;
+   if (fun == &Cell::bif_equal)          return KOP_EQ;
+   if (fun == &Cell::bif_not_equal)      return KOP_NE;
+   if (fun == &Cell::bif_less_than)      return KOP_LT;
+   if (fun == &Cell::bif_less_eq)        return KOP_LE;
+   if (fun == &Cell::bif_greater_than)   return KOP_GT;
+   if (fun == &Cell::bif_greater_eq)     return KOP_GE;
+   return KOP_NONE;
+}
+//----------------------------------------------------------------------------
+Kernel_arg::Kernel_arg(const Value & V)
+   : type(CT_NONE),
+     inc(V.get_increment()),
+     ints(0),
+     reals(0),
+     int1(0),
+     real1(0.0),
+     own_ints(0),
+     own_reals(0)
+{
+   if ((ints = V.get_int_ravel()))      { type = CT_INT;     return; }
+   if ((reals = V.get_float_ravel()))   { type = CT_FLOAT;   return; }
+
+const ShapeItem len = V.element_count();
+   if (len == 1)   // single item
+      {
+        const Cell & cell = V.get_cfirst();
+        if (cell.is_integer_cell())
+           {
+             int1 = cell.get_int_value();
+             ints = &int1;
+             type = CT_INT;
+           }
+#ifndef RATIONAL_NUMBERS_WANTED
+        else if (cell.is_float_cell())
+           {
+             real1 = cell.get_real_value();
+             reals = &real1;
+             type = CT_FLOAT;
+           }
+#endif
+        return;
+      }
+
+   if (const uint64_t * bits = V.get_packed_ravel())
+      {
+        own_ints = Value::new_typed_ravel<APL_Integer>(len, LOC);
+        loop(b, len)   own_ints[b] = (bits[b >> 6] >> (b & 63)) & 1;
+        ints = own_ints;
+        type = CT_INT;
+        return;
+      }
+
+   if (V.is_typed())   return;   // characters
+
+const Cell * C = &V.get_cfirst();
+   if (C->is_integer_cell())
+      {
+        own_ints = Value::new_typed_ravel<APL_Integer>(len, LOC);
+        loop(c, len)
+           {
+             if (!C[c].is_integer_cell())   return;
+             own_ints[c] = C[c].get_int_value();
+           }
+        ints = own_ints;
+        type = CT_INT;
+      }
+#ifndef RATIONAL_NUMBERS_WANTED
+   else if (C->is_float_cell())
+      {
+        own_reals = Value::new_typed_ravel<APL_Float>(len, LOC);
+        loop(c, len)
+           {
+             if (!C[c].is_float_cell())   return;
+             own_reals[c] = C[c].get_real_value();
+           }
+        reals = own_reals;
+        type = CT_FLOAT;
+      }
+#endif
+}
+//----------------------------------------------------------------------------
+const APL_Float *
+Kernel_arg::get_reals(ShapeItem len)
+{
+   if (reals)   return reals;
+
+   if (inc == 0)   // single item
+      {
+        real1 = ints[0];
+        return reals = &real1;
+      }
+
+   own_reals = Value::new_typed_ravel<APL_Float>(len, LOC);
+   loop(r, len)   own_reals[r] = ints[r];
+   return reals = own_reals;
+}
+//----------------------------------------------------------------------------
+/// Z[z] ← A[z] OP B[z] for all z (with scalar extension of A or B).
+/// Return \b true on success. If Z is 0 then only check for success.
+template<typename OP, typename T>
+SIMD_INLINE bool
+arith_loop(T * Z, const T * A, int inc_A, const T * B, int inc_B,
+           ShapeItem len)
+{
+uint64_t bad = 0;
+   if (Z == 0)   // check only
+      {
+        if (inc_A && inc_B)   loop(z, len)   OP::fun(A[z], B[z], bad);
+        else if (inc_B)       loop(z, len)   OP::fun(A[0], B[z], bad);
+        else                  loop(z, len)   OP::fun(A[z], B[0], bad);
+      }
+   else if (inc_A && inc_B)
+      {
+        loop(z, len)   Z[z] = OP::fun(A[z], B[z], bad);
+      }
+   else if (inc_B)   // scalar A
+      {
+        const T a = A[0];
+        loop(z, len)   Z[z] = OP::fun(a, B[z], bad);
+      }
+   else              // scalar B
+      {
+        const T b = B[0];
+        loop(z, len)   Z[z] = OP::fun(A[z], b, bad);
+      }
+   return bad == 0;
+}
+//----------------------------------------------------------------------------
+/// the number of items per chunk of chunk_loop() and promote_overflow()
+enum { OVERFLOW_CHUNK = 256 };
+
+/// Z[z] ← A[z] OP B[z] for all z, computed in chunks of OVERFLOW_CHUNK
+/// items. Set \b bad_chunks[c] if chunk c had an overflow. Return \b true
+/// if no chunk had one.
+template<typename OP>
+SIMD_INLINE bool
+chunk_loop(APL_Integer * Z, const APL_Integer * A, int inc_A,
+           const APL_Integer * B, int inc_B, ShapeItem len, char * bad_chunks)
+{
+bool ok = true;
+   for (ShapeItem z0 = 0; z0 < len; z0 += OVERFLOW_CHUNK)
+       {
+         const ShapeItem count = (len - z0) < OVERFLOW_CHUNK
+                               ? (len - z0) : OVERFLOW_CHUNK;
+         const bool bad = !arith_loop<OP>(Z + z0, A + z0 * inc_A, inc_A,
+                                                  B + z0 * inc_B, inc_B, count);
+         bad_chunks[z0 / OVERFLOW_CHUNK] = bad;
+         if (bad)   ok = false;
+       }
+   return ok;
+}
+//----------------------------------------------------------------------------
+/// integer A op B (except ÷ and ∣). Return \b true on success. If
+/// \b bad_chunks is non-0 then + - × set \b bad_chunks[c] for every chunk c
+/// (of OVERFLOW_CHUNK items) that had an overflow.
+SIMD_KERNEL static bool
+int_kernel(Kernel_op op, APL_Integer * Z, const APL_Integer * A, int inc_A,
+           const APL_Integer * B, int inc_B, ShapeItem len,
+           char * bad_chunks = 0)
+{
+   if (bad_chunks)   switch(op)
+      {
+        case KOP_ADD: return chunk_loop<Int_add>(Z, A, inc_A, B, inc_B, len,
+                                                 bad_chunks);
+        case KOP_SUB: return chunk_loop<Int_sub>(Z, A, inc_A, B, inc_B, len,
+                                                 bad_chunks);
+        case KOP_MUL: return chunk_loop<Int_mul>(Z, A, inc_A, B, inc_B, len,
+                                                 bad_chunks);
+        default:      break;
+      }
+
+   switch(op)
+      {
+        case KOP_ADD: return arith_loop<Int_add>(Z, A, inc_A, B, inc_B, len);
+        case KOP_SUB: return arith_loop<Int_sub>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MUL: return arith_loop<Int_mul>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MAX: return arith_loop<Int_max>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MIN: return arith_loop<Int_min>(Z, A, inc_A, B, inc_B, len);
+        default:      return false;
+      }
+}
+//----------------------------------------------------------------------------
+/// the items of integer A OP B that had an overflow: set Z (a Cell ravel) to
+/// the items of ints_Z (as computed by int_kernel()), except for the chunks
+/// in \b bad_chunks, which are computed again item by item in double
+/// precision where needed.
+template<typename OP>
+static void
+promote_loop(Value & Z, const APL_Integer * ints_Z, const char * bad_chunks,
+             const APL_Integer * A, int inc_A,
+             const APL_Integer * B, int inc_B, ShapeItem len)
+{
+   for (ShapeItem z0 = 0; z0 < len; z0 += OVERFLOW_CHUNK)
+       {
+         const ShapeItem count = (len - z0) < OVERFLOW_CHUNK
+                               ? (len - z0) : OVERFLOW_CHUNK;
+         const APL_Integer * A0 = A + z0 * inc_A;
+         const APL_Integer * B0 = B + z0 * inc_B;
+         if (!bad_chunks[z0 / OVERFLOW_CHUNK])
+            {
+              loop(z, count)   Z.next_ravel_Int(ints_Z[z0 + z]);
+              continue;
+            }
+
+         // this chunk had an overflow
+         loop(z, count)
+            {
+              const APL_Integer a = A0[z * inc_A];
+              const APL_Integer b = B0[z * inc_B];
+              uint64_t bad = 0;
+              const APL_Integer iz = OP::fun(a, b, bad);
+              if (bad)   Z.next_ravel_Float(OP::real(a, b));
+              else       Z.next_ravel_Int(iz);
+            }
+       }
+}
+//----------------------------------------------------------------------------
+/// integer A op B (+ - ×) where int_kernel() has reported an overflow in
+/// the chunks \b bad_chunks. Return the result (with IntCells and
+/// FloatCells), or 0 for other ops.
+static Value_P
+promote_overflow(Kernel_op op, const Shape & shape_Z,
+                 const APL_Integer * ints_Z, const char * bad_chunks,
+                 const APL_Integer * A, int inc_A,
+                 const APL_Integer * B, int inc_B, ShapeItem len)
+{
+   if (op != KOP_ADD && op != KOP_SUB && op != KOP_MUL)   return Value_P();
+
+Value_P Z(shape_Z, LOC);
+   switch(op)
+      {
+        case KOP_ADD: promote_loop<Int_add>(*Z, ints_Z, bad_chunks,
+                                            A, inc_A, B, inc_B, len);
+                      break;
+        case KOP_SUB: promote_loop<Int_sub>(*Z, ints_Z, bad_chunks,
+                                            A, inc_A, B, inc_B, len);
+                      break;
+        default:      promote_loop<Int_mul>(*Z, ints_Z, bad_chunks,
+                                            A, inc_A, B, inc_B, len);
+      }
+   Z->check_value(LOC);
+   return Z;
+}
+//----------------------------------------------------------------------------
+/// real A op B (except ∣). Return \b true on success.
+SIMD_KERNEL static bool
+float_kernel(Kernel_op op, APL_Float * Z, const APL_Float * A, int inc_A,
+             const APL_Float * B, int inc_B, ShapeItem len)
+{
+   switch(op)
+      {
+        case KOP_ADD: return arith_loop<Flt_add>(Z, A, inc_A, B, inc_B, len);
+        case KOP_SUB: return arith_loop<Flt_sub>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MUL: return arith_loop<Flt_mul>(Z, A, inc_A, B, inc_B, len);
+        case KOP_DIV: return arith_loop<Flt_div>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MAX: return arith_loop<Flt_max>(Z, A, inc_A, B, inc_B, len);
+        case KOP_MIN: return arith_loop<Flt_min>(Z, A, inc_A, B, inc_B, len);
+        default:      return false;
+      }
+}
+//----------------------------------------------------------------------------
+/// integer A ÷ B (as in IntCell::bif_divide()). Return \b true on success.
+static bool
+int_divide(APL_Float * Z, const APL_Integer * A, int inc_A,
+           const APL_Integer * B, int inc_B, ShapeItem len)
+{
+   loop(z, len)
+      {
+        const APL_Integer a = A[z * inc_A];
+        const APL_Integer b = B[z * inc_B];
+        if (b == 0)    return false;   // 0÷0 is an integer, A÷0 an error
+        if (b == -1)   { Z[z] = -APL_Float(a);   continue; }
+
+        const APL_Float i_quot = a / b;
+        Z[z] = (a != i_quot * b) ? a / APL_Float(b) : i_quot;
+      }
+   return true;
+}
+//----------------------------------------------------------------------------
+/// integer A ∣ B (as in IntCell::bif_residue()). Return \b true on success.
+static bool
+int_residue(APL_Integer * Z, const APL_Integer * A, int inc_A,
+            const APL_Integer * B, int inc_B, ShapeItem len, double qct)
+{
+   loop(z, len)
+      {
+        const APL_Integer a = A[z * inc_A];
+        const APL_Integer b = B[z * inc_B];
+        if (a == 0)   { Z[z] = b;   continue; }
+        if (a > (BIG_INT64_F - 1E10) || a < (1E10 - BIG_INT64_F))
+           return false;   // computed as for floats
+        if (b == 0 || a == -1)   { Z[z] = 0;   continue; }
+
+        if (qct != 0)   // B÷A close to an integer
+           {
+             const APL_Float quot = b / APL_Float(a);
+             if (quot > ceil(quot) - qct)    { Z[z] = 0;   continue; }
+             if (quot < floor(quot) + qct)   { Z[z] = 0;   continue; }
+           }
+
+        APL_Integer rest = b % a;
+        if (a < 0)   { if (rest > 0)   rest += a; }   // A negative: Z ≤ 0
+        else         { if (rest < 0)   rest += a; }   // A positive: Z ≥ 0
+        Z[z] = rest;
+      }
+   return true;
+}
+//----------------------------------------------------------------------------
+// the comparison kernel operations. fun() returns A op B.
+
+/// A = B
+struct Cmp_eq
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a == b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return Cell::tolerantly_equal(a, b, qct); }
+};
+
+/// A ≠ B
+struct Cmp_ne
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a != b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return !Cell::tolerantly_equal(a, b, qct); }
+};
+
+/// A < B
+struct Cmp_lt
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a < b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return a < b && !Cell::tolerantly_equal(a, b, qct); }
+};
+
+/// A ≤ B
+struct Cmp_le
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a <= b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return a < b || Cell::tolerantly_equal(a, b, qct); }
+};
+
+/// A > B
+struct Cmp_gt
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a > b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return a > b && !Cell::tolerantly_equal(a, b, qct); }
+};
+
+/// A ≥ B
+struct Cmp_ge
+{
+   static SIMD_INLINE bool fun(APL_Integer a, APL_Integer b, double qct)
+      { return a >= b; }
+   static SIMD_INLINE bool fun(APL_Float a, APL_Float b, double qct)
+      { return a > b || Cell::tolerantly_equal(a, b, qct); }
+};
+//----------------------------------------------------------------------------
+/// packed Z[z] ← A[z] OP B[z] for all z (with scalar extension of A or B)
+template<typename OP, typename T>
+SIMD_INLINE void
+compare_loop(uint64_t * Z, const T * A, int inc_A, const T * B, int inc_B,
+             ShapeItem len, double qct)
+{
+   for (ShapeItem z0 = 0; z0 < len; z0 += 64)
+       {
+         const int count = (len - z0) < 64 ? (len - z0) : 64;
+         const T * A0 = A + z0 * inc_A;
+         const T * B0 = B + z0 * inc_B;
+         uint64_t word = 0;
+         loop(b, count)
+             word |= uint64_t(OP::fun(A0[b * inc_A], B0[b * inc_B], qct)) << b;
+         Z[z0 >> 6] = word;
+       }
+}
+//----------------------------------------------------------------------------
+/// packed integer A op B
+SIMD_KERNEL static void
+int_compare(Kernel_op op, uint64_t * Z, const APL_Integer * A, int inc_A,
+            const APL_Integer * B, int inc_B, ShapeItem len)
+{
+   switch(op)
+      {
+        case KOP_EQ: compare_loop<Cmp_eq>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        case KOP_NE: compare_loop<Cmp_ne>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        case KOP_LT: compare_loop<Cmp_lt>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        case KOP_LE: compare_loop<Cmp_le>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        case KOP_GT: compare_loop<Cmp_gt>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        case KOP_GE: compare_loop<Cmp_ge>(Z, A, inc_A, B, inc_B, len, 0);  break;
+        default:     Assert(0 && "bad comparison");
+      }
+}
+//----------------------------------------------------------------------------
+/// packed real A op B (tolerant within qct)
+static void
+float_compare(Kernel_op op, uint64_t * Z, const APL_Float * A, int inc_A,
+              const APL_Float * B, int inc_B, ShapeItem len, double qct)
+{
+   switch(op)
+      {
+        case KOP_EQ: compare_loop<Cmp_eq>(Z, A, inc_A, B, inc_B, len, qct); break;
+        case KOP_NE: compare_loop<Cmp_ne>(Z, A, inc_A, B, inc_B, len, qct); break;
+        case KOP_LT: compare_loop<Cmp_lt>(Z, A, inc_A, B, inc_B, len, qct); break;
+        case KOP_LE: compare_loop<Cmp_le>(Z, A, inc_A, B, inc_B, len, qct); break;
+        case KOP_GT: compare_loop<Cmp_gt>(Z, A, inc_A, B, inc_B, len, qct); break;
+        case KOP_GE: compare_loop<Cmp_ge>(Z, A, inc_A, B, inc_B, len, qct); break;
+        default:     Assert(0 && "bad comparison");
+      }
+}
+//----------------------------------------------------------------------------
+/// return \b true if the kernel for \b op can fail (i.e. return \b false)
+static bool
+kernel_may_fail(Kernel_op op, bool ints)
+{
+   if (ints)   return op == KOP_ADD || op == KOP_SUB || op == KOP_MUL;
+   else        return op == KOP_MUL || op == KOP_DIV;
+}
+//----------------------------------------------------------------------------
+/// return the temporary value \b temp_A or \b temp_B (if any) whose typed
+/// ravel can be overwritten by Z, since it has the shape and type of Z.
+static Value *
+reusable_temp(Value * temp_A, Value * temp_B, const Shape & shape_Z,
+              bool ints)
+{
+   loop(t, 2)
+      {
+        Value * temp = t ? temp_A : temp_B;
+        if (temp == 0)                          continue;
+        if (temp->get_shape() != shape_Z)       continue;
+        if (ints ? temp->get_int_ravel() == 0
+                 : temp->get_float_ravel() == 0)   continue;
+
+        Log(LOG_optimization)
+           CERR << "optimizing A fun B (Z in place of " << (t ? "A" : "B")
+                << ", len=" << shape_Z.get_volume() << ")" << endl;
+        return temp;
+      }
+
+   return 0;
+}
+//----------------------------------------------------------------------------
+Value_P
+ScalarFunction::typed_scalar_AB(const Value & A, const Value & B, prim_f2 fun,
+                                Value * temp_A, Value * temp_B)
+{
+const Kernel_op op = kernel_op(fun);
+   if (op == KOP_NONE)   return Value_P();
+
+ErrorCode ec = E_NO_ERROR;
+const Shape * shape_Z = conforming_shape(ec, A.get_shape(), B.get_shape());
+   if (ec != E_NO_ERROR)   return Value_P();   // let the caller complain
+
+const ShapeItem len_Z = shape_Z->get_volume();
+   if (len_Z < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+Kernel_arg arg_A(A);
+   if (arg_A.type == CT_NONE)   return Value_P();
+Kernel_arg arg_B(B);
+   if (arg_B.type == CT_NONE)   return Value_P();
+
+const bool ints = arg_A.type == CT_INT && arg_B.type == CT_INT;
+
+   if (op >= KOP_EQ)   // comparison: packed Z
+      {
+        uint64_t * bits_Z =
+                 Value::new_typed_ravel<uint64_t>((len_Z + 63) >> 6, LOC);
+        if (ints)   int_compare(op, bits_Z, arg_A.ints, arg_A.inc,
+                                            arg_B.ints, arg_B.inc, len_Z);
+        else        float_compare(op, bits_Z,
+                                  arg_A.get_reals(len_Z), arg_A.inc,
+                                  arg_B.get_reals(len_Z), arg_B.inc,
+                                  len_Z, Workspace::get_CT());
+        return Value_P(*shape_Z, bits_Z, LOC);
+      }
+
+   if (ints && op == KOP_DIV)   // integer A ÷ B: real Z
+      {
+#ifdef RATIONAL_NUMBERS_WANTED
+        return Value_P();   // rational Z
+#else
+        APL_Float * reals_Z = Value::new_typed_ravel<APL_Float>(len_Z, LOC);
+        if (int_divide(reals_Z, arg_A.ints, arg_A.inc,
+                                arg_B.ints, arg_B.inc, len_Z))
+           return Value_P(*shape_Z, reals_Z, LOC);
+        delete[] reals_Z;
+        return Value_P();
+#endif
+      }
+
+   if (ints && op != KOP_RES)   // maybe Z in place of A or B
+      {
+        Value * temp = reusable_temp(temp_A, temp_B, *shape_Z, true);
+        if (temp && (!kernel_may_fail(op, true) ||
+                     int_kernel(op, 0, arg_A.ints, arg_A.inc,
+                                       arg_B.ints, arg_B.inc, len_Z)))
+           {
+             int_kernel(op, temp->get_int_wravel(), arg_A.ints, arg_A.inc,
+                                                    arg_B.ints, arg_B.inc,
+                                                    len_Z);
+             return Value_P(temp, LOC);
+           }
+      }
+
+   if (ints)   // integer A op B: integer Z
+      {
+        std::vector<char> bad_chunks((len_Z + OVERFLOW_CHUNK - 1)
+                                     / OVERFLOW_CHUNK, 0);
+        APL_Integer * ints_Z = Value::new_typed_ravel<APL_Integer>(len_Z, LOC);
+        const bool ok = (op == KOP_RES)
+                      ? int_residue(ints_Z, arg_A.ints, arg_A.inc,
+                                            arg_B.ints, arg_B.inc, len_Z,
+                                            Workspace::get_CT())
+                      : int_kernel(op, ints_Z, arg_A.ints, arg_A.inc,
+                                               arg_B.ints, arg_B.inc, len_Z,
+                                               &bad_chunks[0]);
+        if (ok)   return Value_P(*shape_Z, ints_Z, LOC);
+
+        // some items overflowed and become real. Only the chunks that
+        // overflowed are computed again.
+        Value_P Z;
+        try
+           {
+             Z = promote_overflow(op, *shape_Z, ints_Z, &bad_chunks[0],
+                                  arg_A.ints, arg_A.inc,
+                                  arg_B.ints, arg_B.inc, len_Z);
+           }
+        catch (...)
+           {
+             delete[] ints_Z;
+             throw;
+           }
+        delete[] ints_Z;
+        return Z;
+      }
+
+   // at least one of A and B is real. Only + - × can mix integers and reals
+   // (since the Cell functions convert the integer to real).
+   //
+   if (op == KOP_RES)   return Value_P();
+   if (arg_A.type != arg_B.type &&
+       op != KOP_ADD && op != KOP_SUB && op != KOP_MUL)   return Value_P();
+
+const APL_Float * reals_A = arg_A.get_reals(len_Z);
+const APL_Float * reals_B = arg_B.get_reals(len_Z);
+
+   if (Value * temp = reusable_temp(temp_A, temp_B, *shape_Z, false))
+      {
+        if (!kernel_may_fail(op, false) ||
+            float_kernel(op, 0, reals_A, arg_A.inc, reals_B, arg_B.inc, len_Z))
+           {
+             float_kernel(op, temp->get_float_wravel(), reals_A, arg_A.inc,
+                                                        reals_B, arg_B.inc,
+                                                        len_Z);
+             return Value_P(temp, LOC);
+           }
+      }
+
+APL_Float * reals_Z = Value::new_typed_ravel<APL_Float>(len_Z, LOC);
+   if (float_kernel(op, reals_Z, reals_A, arg_A.inc,
+                                 reals_B, arg_B.inc, len_Z))
+      return Value_P(*shape_Z, reals_Z, LOC);
+
+   delete[] reals_Z;
+   return Value_P();
+}
 //----------------------------------------------------------------------------
 Token
 ScalarFunction::eval_scalar_AB(Value_P A, Value_P B, prim_f2 fun) const
 {
+   // if A and B are simple numeric: try a typed kernel first.
+   //
+   // If A fun B was called from Prefix::reduce_A_F_B_() then its typed Z
+   // is a temporary value (see Value::set_temp()) that only the prefix
+   // holds. The ravel of a temporary A or B is discarded after we return
+   // and can therefore be overwritten with Z. In a chain of scalar
+   // functions like 1+2×3-B that avoids a new ravel for every function.
+   //
+   {
+     const StateIndicator * si = Workspace::SI_top();
+     const bool from_prefix =
+                si && this == si->get_prefix().get_dyadic_fun();
+     Value * temp_A = from_prefix && A->is_temp() ? A.get() : 0;
+     Value * temp_B = from_prefix && B->is_temp() ? B.get() : 0;
+     Value_P Z = typed_scalar_AB(*A, *B, fun, temp_A, temp_B);
+     if (+Z)
+        {
+          if (from_prefix)   Z->set_temp();
+          return Token(TOK_APL_VALUE1, Z);
+        }
+   }
+
+   if (get_bool_f2_bool())   // boolean Z: try a packed Z first
+      {
+        Value_P Z = packed_scalar_AB(A, B, fun);
+        if (+Z)   return Token(TOK_APL_VALUE1, Z);
+      }
+
 PERFORMANCE_START(start)
 
 ErrorCode ec = E_NO_ERROR;
@@ -410,6 +1057,10 @@ const bool maybe_parallel = Parallel::run_parallel &&
               //
               job_AB->fun = this;
               job_AB->fun2 = fun;
+              job_AB->value_A->explode();   // before the workers read A
+              job_AB->value_B->explode();   // before the workers read B
+              Thread_context::M_distribute_work(job_AB->len_Z,
+                                       Thread_context::get_active_core_count());
               Thread_context::do_work = PF_scalar_AB;
               Thread_context::M_fork("eval_scalar_AB");   // start pool
               PF_scalar_AB(Thread_context::get_master());
@@ -560,14 +1211,8 @@ ScalarFunction::PF_scalar_AB(Thread_context & tctx)
       * PointerCell constructors (change their parents)
     */
 
-const CoreCount cores = Thread_context::get_active_core_count();
-
-const ShapeItem slice_len = (job_AB->len_Z + cores - 1) / cores;
-ShapeItem z = tctx.get_N() * slice_len;
-
-ShapeItem end_z = z + slice_len;
-   if (end_z > job_AB->len_Z)   end_z = job_AB->len_Z;
-
+ShapeItem z, end_z;
+   while (tctx.PF_next_chunk(z, end_z))
    for (; z < end_z; ++z)
        {
          const Cell & cell_A = job_AB->A_at(z);
@@ -629,7 +1274,7 @@ CELL_PERFORMANCE_END(job_AB->fun->get_statistics_AB(), start_2, z)
                  }
               else                // nested A and nested B
                  {
-                   Value_P A1(cell_A, LOC);
+                   Value_P A1 = cell_A.get_pointer_value();
                    Value_P B1 = cell_B.get_pointer_value();
                    const Shape * sh_Z1 = conforming_shape(job_AB->error,
                                                           B1->get_shape(),
@@ -657,6 +1302,8 @@ CELL_PERFORMANCE_END(job_AB->fun->get_statistics_AB(), start_2, z)
                              Parallel::release_lock(jobs_lock);
                              return;
                            }
+                        Value_P Z1 = result.get_apl_val();
+                        new (&cell_Z) PointerCell(Z1.get(), *job_AB->value_Z);
                       }
                  }
 
@@ -905,6 +1552,155 @@ const Cell * cB = &B->get_cfirst();
    return Z;
 }
 //---------------------------------------------------------------------------
+bool
+ScalarFunction::parallel_wanted(ShapeItem len_Z, bool dyadic) const
+{
+#if PARALLEL_ENABLED
+   if (!Parallel::run_parallel)                       return false;
+   if (Thread_context::get_active_core_count() < 2)   return false;
+   if (dyadic)   return len_Z > get_dyadic_threshold();
+   return may_parallel() && len_Z > get_monadic_threshold();
+#else
+   return false;
+#endif // PARALLEL_ENABLED
+}
+//---------------------------------------------------------------------------
+const uint64_t *
+ScalarFunction::packed_words(const Value & V, uint64_t & word)
+{
+   if (V.element_count() != 1)   return V.get_packed_ravel();
+
+const Cell & cell_V = V.get_cfirst();
+   if (!cell_V.is_integer_cell())   return 0;
+
+   switch(cell_V.get_int_value())
+      {
+        case 0:  word = 0;             return &word;
+        case 1:  word = ~uint64_t(0);  return &word;
+        default: return 0;
+      }
+}
+//---------------------------------------------------------------------------
+Value_P
+ScalarFunction::packed_scalar_B(Value_P B, prim_f1 fun) const
+{
+const ShapeItem len_Z = B->element_count();
+   if (len_Z < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+const ShapeItem words = (len_Z + 63) >> 6;
+uint64_t * bits_Z = Value::new_typed_ravel<uint64_t>(words, LOC);
+
+   if (const uint64_t * bits_B = B->get_packed_ravel())   // word-at-a-time
+      {
+        const bool_f1_bool fun_bits = get_bool_f1_bool();
+        loop(w, words)   bits_Z[w] = fun_bits(bits_B[w]);
+        bits_Z[words - 1] &= Value::packed_tail_mask(len_Z);
+        return Value_P(B->get_shape(), bits_Z, LOC);
+      }
+
+   // Cell by Cell (without exploding a typed B), giving up as soon as some
+   // result is not boolean. Above the parallel threshold the caller computes
+   // Z Cell by Cell in parallel instead.
+   //
+   if (parallel_wanted(len_Z, false))
+      {
+        delete[] bits_Z;
+        return Value_P();
+      }
+
+   loop(w, words)   bits_Z[w] = 0;
+   loop(z, len_Z)
+      {
+        uint64_t buffer_B[sizeof(Cell) / sizeof(uint64_t)];   // not a Cell
+        const Cell & cell_B =
+                     B->get_cravel(z, reinterpret_cast<Cell *>(buffer_B));
+        uint64_t buffer_Z[sizeof(Cell) / sizeof(uint64_t)];   // not a Cell
+        Cell & cell_Z = *reinterpret_cast<Cell *>(buffer_Z);  // (vtable!)
+        if (!cell_B.is_simple_cell()                ||
+            (cell_B.*fun)(&cell_Z) != E_NO_ERROR    ||
+            !cell_Z.is_integer_cell()               ||
+            (cell_Z.get_int_value() & ~APL_Integer(1)))
+           {
+             delete[] bits_Z;
+             return Value_P();   // let the caller compute (and complain)
+           }
+
+        if (cell_Z.get_int_value())   bits_Z[z >> 6] |= uint64_t(1) << (z & 63);
+      }
+
+   return Value_P(B->get_shape(), bits_Z, LOC);
+}
+//---------------------------------------------------------------------------
+Value_P
+ScalarFunction::packed_scalar_AB(Value_P A, Value_P B, prim_f2 fun) const
+{
+ErrorCode ec = E_NO_ERROR;
+const Shape * shape_Z = conforming_shape(ec, A->get_shape(), B->get_shape());
+   if (ec != E_NO_ERROR)   return Value_P();   // let the caller complain
+
+const ShapeItem len_Z = shape_Z->get_volume();
+   if (len_Z < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+const ShapeItem words = (len_Z + 63) >> 6;
+uint64_t * bits_Z = Value::new_typed_ravel<uint64_t>(words, LOC);
+
+   // word-at-a-time if A and B are both packed (or boolean scalars)
+   //
+   {
+     uint64_t word_A, word_B;
+     const uint64_t * bits_A = packed_words(*A, word_A);
+     const uint64_t * bits_B = packed_words(*B, word_B);
+     if (bits_A && bits_B)
+        {
+          const ShapeItem inc_A = (bits_A == &word_A) ? 0 : 1;
+          const ShapeItem inc_B = (bits_B == &word_B) ? 0 : 1;
+          const bool_f2_bool fun_bits = get_bool_f2_bool();
+          loop(w, words)
+             bits_Z[w] = fun_bits(bits_A[w * inc_A], bits_B[w * inc_B]);
+          bits_Z[words - 1] &= Value::packed_tail_mask(len_Z);
+          return Value_P(*shape_Z, bits_Z, LOC);
+        }
+   }
+
+   // Cell by Cell (without exploding a typed A or B), giving up as soon as
+   // some result is not boolean. Above the parallel threshold the caller
+   // computes Z Cell by Cell in parallel instead.
+   //
+   if (parallel_wanted(len_Z, true))
+      {
+        delete[] bits_Z;
+        return Value_P();
+      }
+
+const int inc_A = A->get_increment();
+const int inc_B = B->get_increment();
+   loop(w, words)   bits_Z[w] = 0;
+   loop(z, len_Z)
+      {
+        uint64_t buffer_A[sizeof(Cell) / sizeof(uint64_t)];   // not a Cell
+        uint64_t buffer_B[sizeof(Cell) / sizeof(uint64_t)];   // not a Cell
+        const Cell & cell_A =
+                     A->get_cravel(z * inc_A, reinterpret_cast<Cell *>(buffer_A));
+        const Cell & cell_B =
+                     B->get_cravel(z * inc_B, reinterpret_cast<Cell *>(buffer_B));
+        uint64_t buffer_Z[sizeof(Cell) / sizeof(uint64_t)];   // not a Cell
+        Cell & cell_Z = *reinterpret_cast<Cell *>(buffer_Z);  // (vtable!)
+        if (!cell_A.is_simple_cell()                       ||
+            !cell_B.is_simple_cell()                       ||
+            (cell_B.*fun)(&cell_Z, &cell_A) != E_NO_ERROR  ||
+            !cell_Z.is_integer_cell()                      ||
+            (cell_Z.get_int_value() & ~APL_Integer(1)))
+           {
+             delete[] bits_Z;
+             return Value_P();   // let the caller compute (and complain)
+           }
+
+        if (cell_Z.get_int_value())   bits_Z[z >> 6] |= uint64_t(1) << (z & 63);
+      }
+
+   return Value_P(*shape_Z, bits_Z, LOC);
+}
+//---------------------------------------------------------------------------
 const Shape *
 ScalarFunction::conforming_shape(ErrorCode & ec, const Shape & shape_A,
                                                  const Shape & shape_B)
@@ -930,6 +1726,16 @@ Bif_F2_FIND::eval_AB(Value_P A, Value_P B) const
 {
 PERFORMANCE_START(start_1)
 
+   if (A->get_rank() <= B->get_rank())
+      {
+        Value_P Z = find_typed(*A, *B);
+        if (+Z)
+           {
+             PERFORMANCE_END(fs_SCALAR_AB, start_1, Z->element_count());
+             return Token(TOK_APL_VALUE1, Z);
+           }
+      }
+
 const double qct = Workspace::get_CT();
 Value_P Z(B->get_shape(), LOC);
 Shape shape_A;
@@ -1013,6 +1819,199 @@ const Shape weights_B = B->get_shape().get_weights();
 
    return true;
 }
+//----------------------------------------------------------------------------
+/// return the characters of \b V, or 0 if V has other items. The characters
+/// of a Cell ravel are copied into \b own (to be deleted by the caller).
+static const Unicode *
+find_chars(const Value & V, Unicode * & own)
+{
+   if (const Unicode * chars = V.get_char_ravel())   return chars;
+   if (V.is_typed())   return 0;   // numbers
+
+const ShapeItem len = V.element_count();
+   loop(v, len)   if (!V.get_cravel(v).is_character_cell())   return 0;
+
+   own = Value::new_typed_ravel<Unicode>(len, LOC);
+   loop(v, len)   own[v] = V.get_cravel(v).get_char_value();
+   return own;
+}
+//----------------------------------------------------------------------------
+/// A (vector or matrix) pattern of A⍷B with items of type T, which is
+/// searched in the rows of B.
+///
+/// The first row of the pattern is located in a row of B with a
+/// Boyer-Moore-Horspool search (or, for short rows, by scanning for its
+/// first item). The remaining rows of the pattern are then compared with
+/// the following rows of B at the same position.
+template<typename T>
+class Find_pattern
+{
+public:
+   /// constructor: the \b rows × \b cols items \b P
+   Find_pattern(const T * P, ShapeItem rows, ShapeItem cols)
+   : pattern(P),
+     rows_P(rows),
+     cols_P(cols)
+   {
+     // skip[h] is the distance from the last item of the pattern row to
+     // the last (but not the final) pattern item whose hash is h.
+     //
+     loop(h, HASH_SIZE)   skip[h] = cols_P;
+     loop(c, cols_P - 1)   skip[hash(P[c])] = cols_P - 1 - c;
+   }
+
+   /// set bit z0 + j of \b bits_Z for every j where the pattern is found at
+   /// S[j] (in the row S of length \b len_S, with the next rows of B
+   /// following at distance \b stride)
+   void find(const T * S, ShapeItem len_S, ShapeItem stride,
+             uint64_t * bits_Z, ShapeItem z0) const
+      {
+        const ShapeItem end = len_S - cols_P + 1;   // positions to try
+        if (cols_P < HORSPOOL_MINIMUM)   // short pattern: scan for P[0]
+           {
+             const T first = pattern[0];
+             ShapeItem j = 0;
+             for (; j + 8 <= end; j += 8)   // 8 items without branches
+                 {
+                   int hit = 0;
+                   loop(k, 8)   hit |= S[j + k] == first;
+                   if (!hit)   continue;
+                   loop(k, 8)   if (S[j + k] == first)
+                                   set_if_match(S, j + k, stride, bits_Z, z0);
+                 }
+             for (; j < end; ++j)
+                 if (S[j] == first)   set_if_match(S, j, stride, bits_Z, z0);
+             return;
+           }
+
+        const ShapeItem last = cols_P - 1;
+        const T last_item = pattern[last];
+        for (ShapeItem j = 0; j < end;)
+            {
+              const T s = S[j + last];
+              if (s == last_item)   set_if_match(S, j, stride, bits_Z, z0);
+              j += skip[hash(s)];
+            }
+      }
+
+   /// patterns shorter than this are not searched with Horspool
+   enum { HORSPOOL_MINIMUM = 4 };
+
+protected:
+   /// the number of entries in skip
+   enum { HASH_SIZE = 256 };
+
+   /// return the index of \b item in skip
+   static int hash(T item)
+      { return uint64_t(item) & (HASH_SIZE - 1); }
+
+   /// set bit z0 + j of bits_Z if all rows of the pattern are at S[j]
+   void set_if_match(const T * S, ShapeItem j, ShapeItem stride,
+                     uint64_t * bits_Z, ShapeItem z0) const
+      {
+        loop(r, rows_P)
+        loop(c, cols_P)
+            {
+              if (pattern[r*cols_P + c] != S[j + r*stride + c])   return;
+            }
+
+        const ShapeItem z = z0 + j;
+        bits_Z[z >> 6] |= uint64_t(1) << (z & 63);
+      }
+
+   /// the items of the pattern
+   const T * pattern;
+
+   /// the number of rows of the pattern
+   const ShapeItem rows_P;
+
+   /// the number of columns of the pattern
+   const ShapeItem cols_P;
+
+   /// the Horspool shifts
+   ShapeItem skip[HASH_SIZE];
+};
+//----------------------------------------------------------------------------
+/// search the \b rows_A × \b cols_A pattern \b A in the rows of \b B (of
+/// length \b cols_B, \b rows_B rows per plane) and set the bits of matches
+template<typename T>
+static void
+find_pattern(const T * A, ShapeItem rows_A, ShapeItem cols_A,
+             const T * B, ShapeItem len_B, ShapeItem rows_B,
+             ShapeItem cols_B, uint64_t * bits_Z)
+{
+const Find_pattern<T> pattern(A, rows_A, cols_A);
+const ShapeItem plane_len = rows_B * cols_B;
+   for (ShapeItem plane = 0; plane < len_B; plane += plane_len)
+   for (ShapeItem row = 0; row + rows_A <= rows_B; ++row)
+       {
+         const ShapeItem b = plane + row*cols_B;
+         pattern.find(B + b, cols_B, cols_B, bits_Z, b);
+       }
+}
+//----------------------------------------------------------------------------
+Value_P
+Bif_F2_FIND::find_typed(const Value & A, const Value & B)
+{
+const ShapeItem len_A = A.element_count();
+const ShapeItem len_B = B.element_count();
+   if (len_A == 0 || len_B < Value::TYPED_MINIMUM_LENGTH)   return Value_P();
+
+   // A must be a matrix or a vector (or have leading axes of length 1)
+   //
+const sRank rank_A = A.get_rank();
+const sRank rank_B = B.get_rank();
+   loop(r, rank_A - 2)   if (A.get_shape_item(r) != 1)   return Value_P();
+
+const ShapeItem cols_A = rank_A ? A.get_last_shape_item() : 1;
+const ShapeItem rows_A = len_A / cols_A;
+const ShapeItem cols_B = B.get_last_shape_item();
+const ShapeItem rows_B = (rank_B > 1) ? B.get_shape_item(rank_B - 2) : 1;
+
+const ShapeItem words = (len_B + 63) >> 6;
+uint64_t * bits_Z = Value::new_typed_ravel<uint64_t>(words, LOC);
+   loop(w, words)   bits_Z[w] = 0;
+
+   if (cols_A > cols_B || rows_A > rows_B)   // A does not fit into B
+      return Value_P(B.get_shape(), bits_Z, LOC);
+
+Unicode * own_A = 0;
+Unicode * own_B = 0;
+   try
+      {
+        const Unicode * chars_A = find_chars(A, own_A);
+        const Unicode * chars_B = chars_A ? find_chars(B, own_B) : 0;
+        if (chars_A && chars_B)
+           {
+             find_pattern(chars_A, rows_A, cols_A, chars_B, len_B, rows_B,
+                          cols_B, bits_Z);
+             delete[] own_A;
+             delete[] own_B;
+             return Value_P(B.get_shape(), bits_Z, LOC);
+           }
+        delete[] own_A;
+        delete[] own_B;
+
+        // IntCell::equal() of two integers is exact (as opposed to reals)
+        //
+        Kernel_arg arg_A(A);
+        Kernel_arg arg_B(B);
+        if (arg_A.type == CT_INT && arg_B.type == CT_INT)
+           {
+             find_pattern(arg_A.ints, rows_A, cols_A, arg_B.ints, len_B,
+                          rows_B, cols_B, bits_Z);
+             return Value_P(B.get_shape(), bits_Z, LOC);
+           }
+      }
+   catch (...)
+      {
+        delete[] bits_Z;
+        throw;
+      }
+
+   delete[] bits_Z;
+   return Value_P();
+}
 //============================================================================
 Token
 Bif_F12_ROLL::eval_AB(Value_P A, Value_P B) const
@@ -1027,36 +2026,69 @@ APL_Integer set_size = B->get_cfirst().get_near_int();
    if (zlen > set_size)         DOMAIN_ERROR;
    if (zlen <  0)               DOMAIN_ERROR;
    if (set_size <  0)           DOMAIN_ERROR;
-   if (set_size > 0x7FFFFFFF)   DOMAIN_ERROR;
 
-   // at this point, A and B are OK. We use a bitmap 'used' to keep track
-   // of items alrady drawn.
+   // at this point, A and B are OK. The memory needed for drawing is
+   // O(zlen) rather than O(set_size).
    //
+APL_Integer * ravel_Z = Value::new_typed_ravel<APL_Integer>(zlen, LOC);
+   try
+      {
+        deal_draw(ravel_Z, zlen, set_size);
+      }
+   catch (...)
+      {
+        delete[] ravel_Z;
+        throw;
+      }
+
+const APL_Integer qio = Workspace::get_IO();
+   loop(z, zlen)   ravel_Z[z] += qio;
+
+   if (zlen >= Value::TYPED_MINIMUM_LENGTH)
+      {
+        Value_P Z(Shape(zlen), ravel_Z, LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
 Value_P Z(zlen, LOC);
+   loop(z, zlen)   Z->next_ravel_Int(ravel_Z[z]);
+   delete[] ravel_Z;
 
-   // set_size can be rather big, so we new/delete it
+   Z->check_value(LOC);
+   return Token(TOK_APL_VALUE1, Z);
+}
+//----------------------------------------------------------------------------
+void
+Bif_F12_ROLL::deal_draw(APL_Integer * Z, ShapeItem zlen, APL_Integer set_size)
+{
+   // the numbers drawn so far are kept in a hash table (with at least
+   // 2 zlen slots) rather than in a bitmap of set_size bits.
    //
-uint8_t * used = new uint8_t[(set_size + 7)/8];
-   if (used == 0)   throw_apl_error(E_WS_FULL, LOC);
-   memset(used, 0, (set_size + 7)/8);
+int bits = 1;
+   while ((ShapeItem(1) << bits) < 2*zlen)   ++bits;
+
+const uint64_t mask = (uint64_t(1) << bits) - 1;
+const uint64_t unused = ~uint64_t(0);   // never drawn since set_size < 2⋆63
+uint64_t * drawn = Value::new_typed_ravel<uint64_t>(mask + 1, LOC);
+   loop(h, mask + 1)   drawn[h] = unused;
 
    loop(z, zlen)
        {
          const uint64_t rnd = Workspace::get_RL(set_size);
 
-         if (used[rnd >> 3] & 1 << (rnd & 7))   // already drawn: try again
+         uint64_t h = (rnd * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+         while (drawn[h] != unused && drawn[h] != rnd)   h = (h + 1) & mask;
+
+         if (drawn[h] == rnd)   // already drawn: try again
             {
               --z;
               continue;
             }
-         used[rnd >> 3] |= 1 << (rnd & 7);   // remember rnd
-         Z->next_ravel_Int(rnd + Workspace::get_IO());
+         drawn[h] = rnd;   // remember rnd
+         Z[z] = rnd;
        }
 
-   delete [] used;
-
-   Z->check_value(LOC);
-   return Token(TOK_APL_VALUE1, Z);
+   delete[] drawn;
 }
 //----------------------------------------------------------------------------
 Token
@@ -1173,6 +2205,14 @@ Value_P Z(shape_Z, LOC);
 Value_P
 Bif_F12_WITHOUT::large_eval_AB(const Value & A, const Value & B)
 {
+   // if B is simple and has only integers, only characters, or only reals
+   // then look up A in an index of B.
+   //
+   {
+     Value_P Z = SearchIndex::select_members(A, B, false, Workspace::get_CT());
+     if (+Z)   return Z;
+   }
+
 const ShapeItem len_A = A.element_count();
 const ShapeItem len_B = B.element_count();
 
@@ -78,6 +78,33 @@ protected:
    Value_P do_scalar_AB(ErrorCode & ec, Value_P A,
                                         Value_P B, prim_f2 fun) const;
 
+   /// return \b true if fun B (or A fun B if \b dyadic) with \b len_Z
+   /// items would be computed in parallel. The sequential Cell by Cell
+   /// loops of packed_scalar_B() and packed_scalar_AB() are not used in
+   /// that case (the typed and word-at-a-time kernels always are).
+   bool parallel_wanted(ShapeItem len_Z, bool dyadic) const;
+
+   /// compute fun B as a packed boolean value, or return 0 if that is not
+   /// possible (short or non-boolean Z). Requires a get_bool_f1_bool().
+   Value_P packed_scalar_B(Value_P B, prim_f1 fun) const;
+
+   /// compute A fun B as a packed boolean value, or return 0 if that is not
+   /// possible (short or non-boolean Z). Requires a get_bool_f2_bool().
+   Value_P packed_scalar_AB(Value_P A, Value_P B, prim_f2 fun) const;
+
+   /// return the packed ravel of V, or \b word (set to 0 or ~0) if V is a
+   /// single boolean, or else 0.
+   static const uint64_t * packed_words(const Value & V, uint64_t & word);
+
+   /// compute A fun B with a typed (non-Cell) kernel, or return 0 if that
+   /// is not possible (no kernel for fun, A or B not simple numeric, short
+   /// Z, or some item of Z would not have the type of the kernel). The
+   /// typed ravel of \b temp_A or \b temp_B (if non-0, i.e. A resp. B is a
+   /// temporary value) may be overwritten with Z.
+   static Value_P typed_scalar_AB(const Value & A, const Value & B,
+                                  prim_f2 fun, Value * temp_A,
+                                  Value * temp_B);
+
    /// compute cell_A fun cell_B, scalar-extending PointerCells
    void expand_nested(Value * Z, const Cell * cell_A,
                       const Cell * cell_B, prim_f2 fun) const;
@@ -198,6 +225,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_less_than; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A < B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return ~A & B; }
+
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
       { return eval_scalar_identity_fun(B, axis, integer_0); }
@@ -230,6 +265,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_equal; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A = B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return ~(A ^ B); }
+
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
       { return eval_scalar_identity_fun(B, axis, integer_1); }
@@ -328,6 +371,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_greater_than; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A > B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return A & ~B; }
+
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
       { return eval_scalar_identity_fun(B, axis, integer_0); }
@@ -360,6 +411,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_and; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ∧ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return A & B; }
+
    /// return the associative cell function of this function
    virtual assoc_f2 get_assoc() const { return &Cell::bif_and; }
 
@@ -435,6 +494,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_or; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ∨ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return A | B; }
+
    /// return the associative cell function of this function
    virtual assoc_f2 get_assoc() const { return &Cell::bif_or; }
 
@@ -509,6 +576,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_less_eq; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ≤ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return ~A | B; }
+
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
       { return eval_scalar_identity_fun(B, axis, integer_1); }
@@ -541,6 +616,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_greater_eq; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ≥ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return A | ~B; }
+
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
       { return eval_scalar_identity_fun(B, axis, integer_1); }
@@ -572,6 +655,14 @@ public:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_not_equal; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ≠ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return A ^ B; }
+
 protected:
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, sAxis axis) const
@@ -610,6 +701,10 @@ protected:
    /// Return true iff A is contained in B.
    static bool contained(const Shape & shape_A, const Cell * cA,
                          Value_P B, const Shape & idx_B, double qct);
+
+   /// return A⍷B (packed) if A and B have only characters or only integers
+   /// and A is (at most) a matrix, or else 0
+   static Value_P find_typed(const Value & A, const Value & B);
 };
 //----------------------------------------------------------------------------
 /** Scalar function NOR
@@ -635,6 +730,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_nor; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ⍱ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return ~(A | B); }
+
    /// overloaded Function::eval_AXB().
    virtual Token eval_AXB(Value_P A, Value_P X, Value_P B) const
       { return eval_scalar_AXB(A, X, B, &Cell::bif_nor); }
@@ -696,6 +799,14 @@ protected:
    virtual prim_f2 get_scalar_f2() const
       { return &Cell::bif_nand; }
 
+   /// overloaded Function::get_bool_f2_bool()
+   virtual bool_f2_bool get_bool_f2_bool() const
+      { return &packed_bits; }
+
+   /// A ⍲ B for 64 packed booleans A and B
+   static uint64_t packed_bits(uint64_t A, uint64_t B)
+      { return ~(A & B); }
+
    /// overloaded Function::eval_AXB().
    virtual Token eval_AXB(Value_P A, Value_P X, Value_P B) const
       { return eval_scalar_AXB(A, X, B, &Cell::bif_nand); }
@@ -896,6 +1007,12 @@ protected:
    /// recursively check that all ravel elements of B are integers ≥ 0 and
    /// return \b true iff not.
    static bool check_B(const Value & B, double qct);
+
+   /// store \b zlen different random numbers < \b set_size into \b Z by
+   /// drawing again the numbers that were drawn before (so that the same
+   /// ⎕RL always deals the same numbers)
+   static void deal_draw(APL_Integer * Z, ShapeItem zlen,
+                         APL_Integer set_size);
 };
 //----------------------------------------------------------------------------
 /** Scalar function not and non-scalar function without.
@@ -928,6 +1045,14 @@ protected:
    virtual Token eval_B(Value_P B) const
       { return eval_scalar_B(B, &Cell::bif_not); }
 
+   /// overloaded Function::get_bool_f1_bool()
+   virtual bool_f1_bool get_bool_f1_bool() const
+      { return &packed_bits; }
+
+   /// ∼B for 64 packed booleans B
+   static uint64_t packed_bits(uint64_t B)
+      { return ~B; }
+
    /// overloaded Function::get_scalar_f2
    virtual prim_f2 get_scalar_f2() const
       { return 0; }
@@ -0,0 +1,200 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SCALAR_KERNELS_HH_DEFINED__
+#define __SCALAR_KERNELS_HH_DEFINED__
+
+#include <float.h>
+#include <math.h>
+
+#include "Common.hh"
+#include "SystemLimits.hh"
+
+class Value;
+
+//----------------------------------------------------------------------------
+/// a simple numeric argument of a typed kernel. The items are taken from a
+/// typed ravel, from a single (scalar-extended) item, or from a copy of a
+/// packed ravel or of a Cell ravel that has only IntCells or only FloatCells.
+class Kernel_arg
+{
+public:
+   /// constructor: the items of \b V
+   Kernel_arg(const Value & V);
+
+   /// destructor
+   ~Kernel_arg()
+      { delete[] own_ints;   delete[] own_reals; }
+
+   /// CT_INT, CT_FLOAT, or CT_NONE if V cannot be used by a typed kernel
+   CellType type;
+
+   /// 0 for a single (scalar-extended) item, otherwise 1
+   int inc;
+
+   /// the items (if type is CT_INT)
+   const APL_Integer * ints;
+
+   /// return the \b len items as APL_Floats (converting integers if needed)
+   const APL_Float * get_reals(ShapeItem len);
+
+protected:
+   /// the items (if type is CT_FLOAT or after get_reals())
+   const APL_Float * reals;
+
+   /// the single integer item (if inc == 0)
+   APL_Integer int1;
+
+   /// the single real item (if inc == 0)
+   APL_Float real1;
+
+   /// copied integer items (to be deleted)
+   APL_Integer * own_ints;
+
+   /// copied real items (to be deleted)
+   APL_Float * own_reals;
+};
+//----------------------------------------------------------------------------
+// the arithmetic kernel operations. fun() returns A op B and sets \b bad
+// to non-0 if the Cell function would have returned a different type or
+// an error. For integer + - × real() returns A op B in double precision,
+// which is the result of the Cell function if fun() has set bad.
+
+/// integer A + B
+struct Int_add
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { const APL_Integer z = uint64_t(a) + uint64_t(b);
+        bad |= uint64_t((z ^ a) & (z ^ b)) >> 63;   // overflow
+        return z; }
+
+   static APL_Float real(APL_Integer a, APL_Integer b)
+      { return APL_Float(a) + APL_Float(b); }
+};
+
+/// integer A - B
+struct Int_sub
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { const APL_Integer z = uint64_t(a) - uint64_t(b);
+        bad |= uint64_t((a ^ b) & (z ^ a)) >> 63;   // overflow
+        return z; }
+
+   static APL_Float real(APL_Integer a, APL_Integer b)
+      { return APL_Float(a) - APL_Float(b); }
+};
+
+/// integer A × B
+struct Int_mul
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { const APL_Float prod = APL_Float(a) * APL_Float(b);
+        bad |= (prod > LARGE_INT) | (prod < SMALL_INT);
+        return uint64_t(a) * uint64_t(b); }
+
+   static APL_Float real(APL_Integer a, APL_Integer b)
+      { return APL_Float(a) * APL_Float(b); }
+};
+
+/// integer A ⌈ B
+struct Int_max
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { return a >= b ? a : b; }
+};
+
+/// integer A ⌊ B
+struct Int_min
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { return a <= b ? a : b; }
+};
+
+/// real A + B
+struct Flt_add
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { return a + b; }
+};
+
+/// real A - B
+struct Flt_sub
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { return a - b; }
+};
+
+/// real A × B
+struct Flt_mul
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { const APL_Float z = a * b;
+        bad |= !(fabs(z) <= DBL_MAX);   // not finite
+        return z; }
+};
+
+/// real A ÷ B
+struct Flt_div
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { const APL_Float z = a / b;
+        bad |= (b == 0.0) | !(fabs(z) <= DBL_MAX);   // A÷0 or not finite
+        return z; }
+};
+
+/// real A ⌈ B
+struct Flt_max
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { return a >= b ? a : b; }
+};
+
+/// real A ⌊ B
+struct Flt_min
+{
+   static SIMD_INLINE APL_Float fun(APL_Float a, APL_Float b, uint64_t & bad)
+      { return a <= b ? a : b; }
+};
+
+/// boolean A ∧ B (integer A and B that are 0 or 1)
+struct Bool_and
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { bad |= uint64_t(a | b) > 1;   // not boolean: ∧ is LCM
+        return a & b; }
+};
+
+/// boolean A ∨ B (integer A and B that are 0 or 1)
+struct Bool_or
+{
+   static SIMD_INLINE APL_Integer fun(APL_Integer a, APL_Integer b,
+                                      uint64_t & bad)
+      { bad |= uint64_t(a | b) > 1;   // not boolean: ∨ is GCD
+        return a | b; }
+};
+//----------------------------------------------------------------------------
+
+#endif // __SCALAR_KERNELS_HH_DEFINED__
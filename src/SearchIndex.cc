@@ -0,0 +1,614 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+
+#include "ComplexCell.hh"
+#include "Radixsort.hh"
+#include "SearchIndex.hh"
+#include "Value.hh"
+#include "Workspace.hh"
+
+#include "Cell.icc"
+
+//----------------------------------------------------------------------------
+SearchIndex::SearchIndex(const Value & A, ShapeItem stride_A)
+   : kind(KIND_NONE),
+     value_A(A),
+     stride(stride_A),
+     len_A(A.element_count() / stride_A),
+     dup_1(-1),
+     dup_2(-1),
+     min_key(0),
+     direct_len(0),
+     direct(0),
+     hash_keys(0),
+     hash_pos(0),
+     hash_mask(0),
+     hash_shift(64),
+     real_keys(0),
+     real_pos(0),
+     real_len(0)
+{
+   if (len_A == 0)   return;
+
+   if (const APL_Integer * ints = A.get_int_ravel())
+      {
+        kind = KIND_INTS;
+        if (stride == 1)   { build(ints);   return; }
+
+        int64_t * keys = Value::new_typed_ravel<int64_t>(len_A, LOC);
+        loop(a, len_A)   keys[a] = ints[a*stride];
+        build(keys);
+        delete[] keys;
+        return;
+      }
+
+   if (const APL_Float * reals = A.get_float_ravel())
+      {
+        kind = KIND_REALS;
+        if (stride == 1)   { build_reals(reals);   return; }
+
+        APL_Float * keys = Value::new_typed_ravel<APL_Float>(len_A, LOC);
+        loop(a, len_A)   keys[a] = reals[a*stride];
+        build_reals(keys);
+        delete[] keys;
+        return;
+      }
+
+   if (const Unicode * chars = A.get_char_ravel())
+      {
+        int64_t * keys = Value::new_typed_ravel<int64_t>(len_A, LOC);
+        loop(a, len_A)   keys[a] = chars[a*stride];
+        kind = KIND_CHARS;
+        build(keys);
+        delete[] keys;
+        return;
+      }
+
+   if (const uint64_t * bits = A.get_packed_ravel())
+      {
+        int64_t * keys = Value::new_typed_ravel<int64_t>(len_A, LOC);
+        loop(a, len_A)
+           {
+             const ShapeItem pos = a*stride;
+             keys[a] = (bits[pos >> 6] >> (pos & 63)) & 1;
+           }
+        kind = KIND_INTS;
+        build(keys);
+        delete[] keys;
+        return;
+      }
+
+   // a Cell ravel. Find the kind of its items...
+   //
+bool ints = true;    // all items are integers
+bool chars = true;   // all items are characters
+bool reals = true;   // all items are integers or floats (of exact magnitude)
+   loop(a, len_A)
+      {
+        const Cell & cell_A = A.get_cravel(a*stride);
+        if (cell_A.is_integer_cell())
+           {
+             chars = false;
+             const APL_Integer value = cell_A.get_int_value();
+             if (value < -MAX_EXACT_REAL || value > MAX_EXACT_REAL)
+                reals = false;
+           }
+        else if (cell_A.is_float_cell())       ints  = chars = false;
+        else if (cell_A.is_character_cell())   ints  = reals = false;
+        else                                   ints  = chars = reals = false;
+
+        if (!(ints || chars || reals))   return;   // mixed or nested A
+      }
+
+   // ... and build the index from its keys
+   //
+   if (ints || chars)
+      {
+        int64_t * keys = Value::new_typed_ravel<int64_t>(len_A, LOC);
+        if (ints)
+           loop(a, len_A)   keys[a] = A.get_cravel(a*stride).get_int_value();
+        else
+           loop(a, len_A)   keys[a] = A.get_cravel(a*stride).get_char_value();
+        kind = ints ? KIND_INTS : KIND_CHARS;
+        build(keys);
+        delete[] keys;
+      }
+   else
+      {
+        APL_Float * keys = Value::new_typed_ravel<APL_Float>(len_A, LOC);
+        loop(a, len_A)   keys[a] = A.get_cravel(a*stride).get_real_value();
+        kind = KIND_REALS;
+        build_reals(keys);
+        delete[] keys;
+      }
+}
+//----------------------------------------------------------------------------
+/// return the number of Cells that occupy (about) the same memory as
+/// \b bytes bytes
+static inline ShapeItem
+cells_for_bytes(ShapeItem bytes)
+{
+   return (bytes + sizeof(Cell) - 1) / sizeof(Cell);
+}
+//----------------------------------------------------------------------------
+ShapeItem
+SearchIndex::get_cell_count() const
+{
+ShapeItem bytes = sizeof(SearchIndex) + direct_len*sizeof(ShapeItem);
+   if (hash_keys)
+      bytes += (hash_mask + 1)*(sizeof(int64_t) + sizeof(ShapeItem));
+   if (real_keys)
+      bytes += len_A*(sizeof(APL_Float) + sizeof(ShapeItem));
+
+   return cells_for_bytes(bytes);
+}
+//----------------------------------------------------------------------------
+void
+SearchIndex::build(const int64_t * keys)
+{
+int64_t max_key = keys[0];
+   min_key = keys[0];
+   loop(a, len_A)
+      {
+        if (min_key > keys[a])   min_key = keys[a];
+        if (max_key < keys[a])   max_key = keys[a];
+      }
+
+const uint64_t range = uint64_t(max_key) - uint64_t(min_key);
+   if (range < uint64_t(4*len_A + 256))   // small range: direct table
+      {
+        direct_len = range + 1;
+        direct = Value::new_typed_ravel<ShapeItem>(direct_len, LOC);
+        loop(j, direct_len)   direct[j] = len_A;
+
+        // the first position of a key wins, since it is stored last
+        //
+        for (ShapeItem a = len_A - 1; a >= 0; --a)
+            {
+              ShapeItem & pos = direct[uint64_t(keys[a]) - uint64_t(min_key)];
+              if (pos != len_A)   set_duplicate(a, pos);
+              pos = a;
+            }
+        return;
+      }
+
+   // large range: a hash table with at least 2 len_A slots
+   //
+int bits = 1;
+   while ((ShapeItem(1) << bits) < 2*len_A)   ++bits;
+   hash_mask  = (uint64_t(1) << bits) - 1;
+   hash_shift = 64 - bits;
+   hash_keys  = Value::new_typed_ravel<int64_t>(hash_mask + 1, LOC);
+   hash_pos   = Value::new_typed_ravel<ShapeItem>(hash_mask + 1, LOC);
+   loop(h, hash_mask + 1)   hash_pos[h] = -1;
+
+   loop(a, len_A)
+      {
+        const int64_t key = keys[a];
+        for (uint64_t h = hash(key);; h = (h + 1) & hash_mask)
+            {
+              if (hash_pos[h] == -1)   // unused slot: insert key
+                 {
+                   hash_keys[h] = key;
+                   hash_pos[h]  = a;
+                   break;
+                 }
+              if (hash_keys[h] == key)   // keep the first position
+                 {
+                   set_duplicate(hash_pos[h], a);
+                   break;
+                 }
+            }
+      }
+}
+//----------------------------------------------------------------------------
+void
+SearchIndex::build_reals(const APL_Float * reals)
+{
+   // sort the positions of the reals by their value. Radixsort keeps
+   // equal values in the order of their positions.
+   //
+uint64_t * keys = Value::new_typed_ravel<uint64_t>(len_A, LOC);
+ShapeItem * indices = Value::new_typed_ravel<ShapeItem>(len_A, LOC);
+   loop(a, len_A)
+      {
+        keys[a] = Radixsort::real_key(reals[a]);
+        indices[a] = a;
+      }
+   Radixsort::sort(keys, indices, len_A);
+   delete[] keys;
+
+   // keep only the first position of equal reals
+   //
+   real_keys = Value::new_typed_ravel<APL_Float>(len_A, LOC);
+   real_pos  = Value::new_typed_ravel<ShapeItem>(len_A, LOC);
+   loop(j, len_A)
+      {
+        const APL_Float key = reals[indices[j]];
+        if (real_len && real_keys[real_len - 1] == key)
+           {
+             set_duplicate(real_pos[real_len - 1], indices[j]);
+             continue;
+           }
+        real_keys[real_len] = key;
+        real_pos[real_len]  = indices[j];
+        ++real_len;
+      }
+
+   delete[] indices;
+}
+//----------------------------------------------------------------------------
+ShapeItem
+SearchIndex::find_near(APL_Float b, double qct) const
+{
+   // if a is tolerantly equal to b then |a - b| < ⎕CT × max(|a|, |b|),
+   // and therefore |a - b| < 2 ⎕CT |b| (since ⎕CT < 0.5).
+   //
+const APL_Float dist = 2*qct*(b < 0 ? -b : b);
+const APL_Float low  = b - dist;
+const APL_Float high = b + dist;
+
+   // binary search for the first real_keys[j] ≥ low
+   //
+ShapeItem j = 0;
+   for (ShapeItem u = real_len; j < u;)
+       {
+         const ShapeItem half = (j + u) / 2;
+         if (real_keys[half] < low)   j = half + 1;
+         else                         u = half;
+       }
+
+ShapeItem ret = len_A;
+   for (; j < real_len && real_keys[j] <= high; ++j)
+       {
+         if (real_pos[j] < ret &&
+             Cell::tolerantly_equal(real_keys[j], b, qct))   ret = real_pos[j];
+       }
+   return ret;
+}
+//----------------------------------------------------------------------------
+bool
+SearchIndex::find_duplicate(double qct, ShapeItem & pos_1,
+                            ShapeItem & pos_2) const
+{
+   if (dup_1 != -1)   // exactly equal items
+      {
+        pos_1 = dup_1;
+        pos_2 = dup_2;
+        return true;
+      }
+
+   if (kind != KIND_REALS)   return false;
+
+   // different reals can still be tolerantly equal. If they are, then so
+   // are the neighbours between them in real_keys.
+   //
+   for (ShapeItem j = 1; j < real_len; ++j)
+       {
+         if (Cell::tolerantly_equal(real_keys[j - 1], real_keys[j], qct))
+            {
+              const ShapeItem p1 = real_pos[j - 1];
+              const ShapeItem p2 = real_pos[j];
+              pos_1 = p1 < p2 ? p1 : p2;
+              pos_2 = p1 < p2 ? p2 : p1;
+              return true;
+            }
+       }
+
+   return false;
+}
+//----------------------------------------------------------------------------
+ShapeItem
+SearchIndex::find_real(APL_Float b, double qct) const
+{
+   if (kind == KIND_REALS)   return find_near(b, qct);
+   if (kind != KIND_INTS)    return len_A;
+
+   // an integer a is tolerantly equal to b if |a - b| < ⎕CT × max(|a|, |b|).
+   // For small |b| that is < 0.5, so that a can only be the integer nearest
+   // to b. Otherwise several integers could be equal to b.
+   //
+   if (!(fabs(b) < 0.25/qct && fabs(b) < 1E18))   return -1;
+
+const APL_Integer a = llrint(b);
+   if (!Cell::tolerantly_equal(APL_Float(a), b, qct))   return len_A;
+   return find_key(a);
+}
+//----------------------------------------------------------------------------
+ShapeItem
+SearchIndex::find(const Cell & cell_B, double qct) const
+{
+   if (cell_B.is_integer_cell())   return find_int(cell_B.get_int_value(), qct);
+
+   if (cell_B.is_character_cell())
+      return kind == KIND_CHARS ? find_key(cell_B.get_char_value()) : len_A;
+
+   if (cell_B.is_float_cell())   return find_real(cell_B.get_real_value(), qct);
+
+   if (cell_B.is_complex_cell())   return kind == KIND_CHARS ? len_A : -1;
+
+   return len_A;   // nested B is not equal to any (simple) item of A
+}
+//----------------------------------------------------------------------------
+void
+SearchIndex::find_all(const Value & B, double qct, ShapeItem * Z) const
+{
+const ShapeItem len_B = B.element_count();
+
+   if (const APL_Integer * ints = B.get_int_ravel())
+      {
+        if (kind == KIND_INTS)   loop(b, len_B)   Z[b] = find_key(ints[b]);
+        else                     loop(b, len_B)   Z[b] = find_int(ints[b], qct);
+      }
+   else if (const Unicode * chars = B.get_char_ravel())
+      {
+        if (kind == KIND_CHARS)   loop(b, len_B)   Z[b] = find_key(chars[b]);
+        else                      loop(b, len_B)   Z[b] = len_A;
+      }
+   else if (const APL_Float * reals = B.get_float_ravel())
+      {
+        loop(b, len_B)   Z[b] = find_real(reals[b], qct);
+      }
+   else if (const uint64_t * bits = B.get_packed_ravel())
+      {
+        loop(b, len_B)   Z[b] = find_int((bits[b >> 6] >> (b & 63)) & 1, qct);
+      }
+   else
+      {
+        loop(b, len_B)   Z[b] = find(B.get_cravel(b), qct);
+      }
+}
+//----------------------------------------------------------------------------
+void
+SearchIndex::locate_all(const Value & B, double qct, ShapeItem * Z) const
+{
+   find_all(B, qct, Z);
+
+const ShapeItem len_B = B.element_count();
+   loop(b, len_B)
+      {
+        if (Z[b] != -1)   continue;
+
+        // B[b] must be compared with the items of A within ⎕CT
+        //
+        const Cell & cell_B = B.get_cravel(b);
+        Z[b] = len_A;
+        loop(a, len_A)
+           {
+             if (cell_B.equal(value_A.get_cravel(a*stride), qct))
+                { Z[b] = a;   break; }
+           }
+      }
+}
+//----------------------------------------------------------------------------
+Value_P
+SearchIndex::select_members(const Value & A, const Value & B, bool in_B,
+                            double qct)
+{
+const SearchIndex & index = B.get_search_cache().get_index();
+   if (!index.is_valid())   return Value_P();
+
+const ShapeItem len_A = A.element_count();
+const ShapeItem len_B = B.element_count();
+
+   // find the items of A in B and turn their positions into keep flags
+   //
+ShapeItem * keep = Value::new_typed_ravel<ShapeItem>(len_A, LOC);
+   index.locate_all(A, qct, keep);
+
+ShapeItem len_Z = 0;
+   loop(a, len_A)
+      {
+        keep[a] = (keep[a] < len_B) == in_B;
+        len_Z += keep[a];
+      }
+
+   try
+      {
+        // A∩B has the default of B, A∼B that of A
+        //
+        Value_P Z = compress(A, keep, len_Z, in_B ? B : A);
+        delete[] keep;
+        return Z;
+      }
+   catch (...)
+      {
+        delete[] keep;
+        throw;
+      }
+}
+//----------------------------------------------------------------------------
+Value_P
+SearchIndex::unique(const Value & B, double qct)
+{
+const SearchIndex & index = B.get_search_cache().get_index();
+   if (!index.is_valid())   return Value_P();
+
+const ShapeItem len_B = B.element_count();
+
+   // B[b] is unique if it is its own first occurrence in B
+   //
+ShapeItem * keep = Value::new_typed_ravel<ShapeItem>(len_B, LOC);
+   index.locate_all(B, qct, keep);
+
+ShapeItem len_Z = 0;
+   loop(b, len_B)
+      {
+        keep[b] = keep[b] == b;
+        len_Z += keep[b];
+      }
+
+   try
+      {
+        Value_P Z = compress(B, keep, len_Z, B);
+        delete[] keep;
+        return Z;
+      }
+   catch (...)
+      {
+        delete[] keep;
+        throw;
+      }
+}
+//----------------------------------------------------------------------------
+Value_P
+SearchIndex::compress(const Value & B, const ShapeItem * keep, ShapeItem len_Z,
+                      const Value & proto)
+{
+const ShapeItem len_B = B.element_count();
+const Shape shape_Z(len_Z);
+
+   if (len_Z >= Value::TYPED_MINIMUM_LENGTH)   // long Z: keep the type of B
+      {
+        if (const APL_Integer * ints = B.get_int_ravel())
+           {
+             APL_Integer * ints_Z =
+                   Value::new_typed_ravel<APL_Integer>(len_Z, LOC);
+             ShapeItem z = 0;
+             loop(b, len_B)   if (keep[b])   ints_Z[z++] = ints[b];
+             return Value_P(shape_Z, ints_Z, LOC);
+           }
+
+        if (const APL_Float * reals = B.get_float_ravel())
+           {
+             APL_Float * reals_Z = Value::new_typed_ravel<APL_Float>(len_Z, LOC);
+             ShapeItem z = 0;
+             loop(b, len_B)   if (keep[b])   reals_Z[z++] = reals[b];
+             return Value_P(shape_Z, reals_Z, LOC);
+           }
+
+        if (const Unicode * chars = B.get_char_ravel())
+           {
+             Unicode * chars_Z = Value::new_typed_ravel<Unicode>(len_Z, LOC);
+             ShapeItem z = 0;
+             loop(b, len_B)   if (keep[b])   chars_Z[z++] = chars[b];
+             return Value_P(shape_Z, chars_Z, LOC);
+           }
+
+        if (const uint64_t * bits = B.get_packed_ravel())
+           {
+             const ShapeItem words = (len_Z + 63) >> 6;
+             uint64_t * bits_Z = Value::new_typed_ravel<uint64_t>(words, LOC);
+             loop(w, words)   bits_Z[w] = 0;
+             ShapeItem z = 0;
+             loop(b, len_B)
+                {
+                  if (!keep[b])   continue;
+                  bits_Z[z >> 6] |= ((bits[b >> 6] >> (b & 63)) & 1) << (z & 63);
+                  ++z;
+                }
+             return Value_P(shape_Z, bits_Z, LOC);
+           }
+      }
+
+Value_P Z(shape_Z, LOC);
+   loop(b, len_B)   if (keep[b])   Z->next_ravel_Cell(B.get_cravel(b));
+   if (len_Z == 0)   Z->set_default(proto, LOC);
+   Z->check_value(LOC);
+   return Z;
+}
+//============================================================================
+SearchCache::SearchCache(const Value & V)
+   : value(V),
+     ascending(false),
+     unique_stride(0),
+     qct(Workspace::get_CT()),
+     cell_count(0)
+{
+   account(cells_for_bytes(sizeof(SearchCache)));
+}
+//----------------------------------------------------------------------------
+SearchCache::~SearchCache()
+{
+   loop(i, indices.size())   delete indices[i];
+   loop(s, sorted.size())   delete[] sorted[s].indices;
+   Value::total_ravel_count -= cell_count;
+}
+//----------------------------------------------------------------------------
+void
+SearchCache::account(ShapeItem cells)
+{
+   cell_count += cells;
+   Value::total_ravel_count += cells;
+}
+//----------------------------------------------------------------------------
+void
+SearchCache::check_CT()
+{
+const double qct_now = Workspace::get_CT();
+   if (qct == qct_now)   return;
+
+   qct = qct_now;
+   ascending = false;
+   unique_stride = 0;
+   loop(s, sorted.size())
+      {
+        account(-cells_for_bytes(sorted[s].len * sizeof(ShapeItem)));
+        delete[] sorted[s].indices;
+      }
+   sorted.clear();
+}
+//----------------------------------------------------------------------------
+const SearchIndex &
+SearchCache::get_index(ShapeItem stride)
+{
+   loop(i, indices.size())
+      {
+        if (indices[i]->get_stride() == stride)   return *indices[i];
+      }
+
+SearchIndex * index = new SearchIndex(value, stride);
+   indices.push_back(index);
+   account(index->get_cell_count());
+   return *index;
+}
+//----------------------------------------------------------------------------
+const ShapeItem *
+SearchCache::get_sorted(ShapeItem len, greater_fun gf)
+{
+   check_CT();
+   loop(s, sorted.size())
+      {
+        if (sorted[s].gf == gf && sorted[s].len == len)
+           return sorted[s].indices;
+      }
+
+ShapeItem * indices = Value::new_typed_ravel<ShapeItem>(len, LOC);
+   loop(l, len)   indices[l] = l;
+
+const ravel_comp_len ctx = { &value.get_cfirst(), 1 };
+   try
+      {
+        Heapsort<ShapeItem>::sort(indices, len, &ctx, gf);
+        const Sorted srt = { gf, indices, len };
+        sorted.push_back(srt);
+      }
+   catch (...)
+      {
+        delete[] indices;
+        throw;
+      }
+
+   account(cells_for_bytes(len * sizeof(ShapeItem)));
+   return indices;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,309 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2022  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SEARCH_INDEX_HH_DEFINED__
+#define __SEARCH_INDEX_HH_DEFINED__
+
+#include <vector>
+
+#include "Common.hh"
+#include "Heapsort.hh"
+
+class Cell;
+
+//----------------------------------------------------------------------------
+/// An index of the items of a simple value A that has only integers, only
+/// characters, or only real numbers.
+///
+/// ⎕CT does not matter for integers and characters. The first position of
+/// such an item in A is therefore found in O(1) by looking up its key (the
+/// integer or the Unicode) in a table. The table is indexed directly by the
+/// key if the keys of A have a small range, and is an open-addressing hash
+/// table otherwise.
+///
+/// Real numbers are sorted instead, so that the items of A that are equal
+/// to a number within ⎕CT are found in O(log len_A) by a binary search.
+///
+/// The index is used by the search functions A⍳B and A∊B, by the set
+/// functions ∪ ∩ and ∼, and by A ⎕MAP B (which indexes only every second
+/// item of A, i.e. the keys). They get it from the SearchCache of the
+/// indexed value, so that it is built only once for the same value.
+class SearchIndex
+{
+public:
+   /// constructor: an index of the items A[0], A[stride], A[2×stride], ...
+   /// of \b A, or an invalid index if they have different kinds (or are
+   /// nested). Positions are then counted in units of \b stride.
+   SearchIndex(const Value & A, ShapeItem stride = 1);
+
+   /// destructor
+   ~SearchIndex()
+      { delete[] direct;      delete[] hash_keys;   delete[] hash_pos;
+        delete[] real_keys;   delete[] real_pos; }
+
+   /// return the number of Cells that occupy (about) the same memory as
+   /// \b this index (for ⎕WA and friends)
+   ShapeItem get_cell_count() const;
+
+   /// return \b true if \b this index could be built
+   bool is_valid() const
+      { return kind != KIND_NONE; }
+
+   /// return the distance between the indexed items of A
+   ShapeItem get_stride() const
+      { return stride; }
+
+   /// return \b true if two indexed items of A are equal (within \b qct),
+   /// and store their positions into \b pos_1 < \b pos_2.
+   bool find_duplicate(double qct, ShapeItem & pos_1, ShapeItem & pos_2) const;
+
+   /// return the position of the first item of A that is equal to \b cell_B,
+   /// len_A if there is none, or -1 if the index cannot decide it (so that
+   /// cell_B must be compared with the items of A within ⎕CT).
+   ShapeItem find(const Cell & cell_B, double qct) const;
+
+   /// store find(B[b], qct) into Z[b] for every item of \b B
+   void find_all(const Value & B, double qct, ShapeItem * Z) const;
+
+   /// like find_all(), but compare the items of \b B that the index cannot
+   /// decide with the items of A, so that every Z[b] is a position ≤ len_A
+   void locate_all(const Value & B, double qct, ShapeItem * Z) const;
+
+   /// return the items of \b A that are (if \b in_B) or are not (if not
+   /// \b in_B) items of \b B, i.e. A∩B or A∼B, or 0 if B cannot be indexed
+   static Value_P select_members(const Value & A, const Value & B,
+                                 bool in_B, double qct);
+
+   /// return the unique items of \b B in the order of their first
+   /// occurrence, i.e. ((B⍳B)=⍳⍴B)/B, or 0 if B cannot be indexed
+   static Value_P unique(const Value & B, double qct);
+
+   /// return the position of the first item of A that is equal to the
+   /// integer \b b, len_A if there is none, or -1 if the index cannot
+   /// decide it
+   ShapeItem find_int(APL_Integer b, double qct) const
+      {
+        if (kind == KIND_INTS)    return find_key(b);
+        if (kind != KIND_REALS)   return len_A;
+        if (b < -MAX_EXACT_REAL || b > MAX_EXACT_REAL)   return -1;
+        return find_near(b, qct);
+      }
+
+   /// return the position of the first item of A that is equal to the
+   /// real \b b, len_A if there is none, or -1 if the index cannot decide it
+   ShapeItem find_real(APL_Float b, double qct) const;
+
+   /// return the position of the first item of A whose key is \b key, or
+   /// len_A if there is none (for KIND_INTS and KIND_CHARS).
+   ShapeItem find_key(int64_t key) const
+      {
+        if (direct)
+           {
+             const uint64_t offset = uint64_t(key) - uint64_t(min_key);
+             return offset < direct_len ? direct[offset] : len_A;
+           }
+
+        for (uint64_t h = hash(key);; h = (h + 1) & hash_mask)
+            {
+              const ShapeItem pos = hash_pos[h];
+              if (pos == -1)              return len_A;   // not found
+              if (hash_keys[h] == key)    return pos;
+            }
+      }
+
+protected:
+   /// the kind of the items of A
+   enum Kind
+      {
+        KIND_NONE,    ///< no index
+        KIND_INTS,    ///< only integers
+        KIND_CHARS,   ///< only characters
+        KIND_REALS,   ///< only real numbers (integers and floats)
+      };
+
+   /// integers with a larger magnitude may not be exact as APL_Float
+   static const APL_Integer MAX_EXACT_REAL = 0x20000000000000LL;   // 2⋆53
+
+   /// return the items B[b] with keep[b] ≠ 0 (\b len_Z of them) as a vector
+   /// with the type of B and the default (if empty) of \b proto
+   static Value_P compress(const Value & B, const ShapeItem * keep,
+                           ShapeItem len_Z, const Value & proto);
+
+   /// build the table for the \b len_A keys of A
+   void build(const int64_t * keys);
+
+   /// remember that the items at \b pos_1 and \b pos_2 of A are equal
+   void set_duplicate(ShapeItem pos_1, ShapeItem pos_2)
+      { dup_1 = pos_1 < pos_2 ? pos_1 : pos_2;
+        dup_2 = pos_1 < pos_2 ? pos_2 : pos_1; }
+
+   /// build the sorted real_keys and real_pos for the \b len_A reals of A
+   void build_reals(const APL_Float * reals);
+
+   /// return the position of the first item of A that is equal to the
+   /// real \b b within ⎕CT (for KIND_REALS)
+   ShapeItem find_near(APL_Float b, double qct) const;
+
+   /// return the hash table slot for \b key
+   uint64_t hash(int64_t key) const
+      { return (uint64_t(key) * 0x9E3779B97F4A7C15ULL) >> hash_shift; }
+
+   /// the kind of the items of A
+   Kind kind;
+
+   /// the indexed value
+   const Value & value_A;
+
+   /// the distance between the indexed items of value_A
+   const ShapeItem stride;
+
+   /// the number of (indexed) items of A
+   const ShapeItem len_A;
+
+   /// the positions of two exactly equal items of A (or -1 if none)
+   ShapeItem dup_1;
+
+   /// the larger position of the duplicate (or -1 if none)
+   ShapeItem dup_2;
+
+   /// the smallest key of A
+   int64_t min_key;
+
+   /// the length of \b direct
+   uint64_t direct_len;
+
+   /// the position of the first key min_key + j in direct[j] (or len_A)
+   ShapeItem * direct;
+
+   /// the keys of the hash table
+   int64_t * hash_keys;
+
+   /// the positions of the keys in hash_keys (or -1 for an unused slot)
+   ShapeItem * hash_pos;
+
+   /// the number of slots of the hash table - 1 (a power of 2 - 1)
+   uint64_t hash_mask;
+
+   /// 64 - log2(hash_mask + 1)
+   int hash_shift;
+
+   /// the different reals of A, sorted ascendingly
+   APL_Float * real_keys;
+
+   /// the first position in A of real_keys[j]
+   ShapeItem * real_pos;
+
+   /// the length of real_keys and real_pos
+   ShapeItem real_len;
+};
+//----------------------------------------------------------------------------
+/// The search structures of a value V that are built when they are first
+/// needed and are then kept with V (see Value::get_search_cache()) until V
+/// is modified or deleted. Searching repeatedly in the same V (as in
+/// Table⍳Keys or Map ⎕MAP Keys) then builds them only once.
+///
+/// The memory of the structures is accounted like a ravel of V.
+class SearchCache
+{
+public:
+   /// a function that returns \b true if item \b a is greater than \b b
+   typedef Heapsort<ShapeItem>::greater_fun greater_fun;
+
+   /// constructor: no search structures (yet) for \b V
+   SearchCache(const Value & V);
+
+   /// destructor
+   ~SearchCache();
+
+   /// return the SearchIndex of the items V[0], V[stride], ... of V
+   const SearchIndex & get_index(ShapeItem stride = 1);
+
+   /// return the indices 0 ... \b len - 1 sorted according to \b gf (with
+   /// context { &V.get_cfirst(), 1 })
+   const ShapeItem * get_sorted(ShapeItem len, greater_fun gf);
+
+   /// return \b true if get_sorted() with \b gf is cached
+   bool has_sorted(greater_fun gf)
+      { check_CT();
+        loop(s, sorted.size())   if (sorted[s].gf == gf)   return true;
+        return false; }
+
+   /// return \b true if V is known to be sorted strictly ascendingly
+   bool is_ascending()
+      { check_CT();   return ascending; }
+
+   /// remember that V is sorted strictly ascendingly
+   void set_ascending()
+      { check_CT();   ascending = true; }
+
+   /// return \b true if the items V[0], V[stride], ... are known to be
+   /// pairwise different (within ⎕CT)
+   bool is_unique(ShapeItem stride)
+      { check_CT();   return unique_stride == stride; }
+
+   /// remember that the items V[0], V[stride], ... are pairwise different
+   void set_unique(ShapeItem stride)
+      { check_CT();   unique_stride = stride; }
+
+protected:
+   /// a cached result of get_sorted()
+   struct Sorted
+      {
+        /// the compare function of the sort
+        greater_fun gf;
+
+        /// the sorted indices
+        ShapeItem * indices;
+
+        /// the number of indices
+        ShapeItem len;
+      };
+
+   /// add \b cells to the memory of \b this cache
+   void account(ShapeItem cells);
+
+   /// discard the results that depend on ⎕CT if ⎕CT has changed (the
+   /// comparison of real numbers is tolerant)
+   void check_CT();
+
+   /// the value whose search structures are cached
+   const Value & value;
+
+   /// the SearchIndex (for different strides) of \b value
+   std::vector<SearchIndex *> indices;
+
+   /// the cached results of get_sorted()
+   std::vector<Sorted> sorted;
+
+   /// true if \b value is sorted strictly ascendingly
+   bool ascending;
+
+   /// 0, or the stride of the items of \b value that are pairwise different
+   ShapeItem unique_stride;
+
+   /// the ⎕CT of \b sorted, \b ascending, and \b unique_stride
+   double qct;
+
+   /// the number of Cells accounted for \b this cache
+   ShapeItem cell_count;
+};
+//----------------------------------------------------------------------------
+
+#endif // __SEARCH_INDEX_HH_DEFINED__
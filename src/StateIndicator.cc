@@ -38,7 +38,8 @@ StateIndicator::StateIndicator(const Executable * exec, StateIndicator * _par)
      level(_par ? 1 + _par->get_level() : 0),
      error(E_NO_ERROR, LOC),
      current_stack(*this, exec->get_body()),
-     parent(_par)
+     parent(_par),
+     eoc_handler(0)
 {
 }
 //----------------------------------------------------------------------------
@@ -49,6 +50,7 @@ StateIndicator::~StateIndicator()
    //
    current_stack.clean_up();
    fun_oper_cache.reset();
+   delete eoc_handler;
 
    // if executable is a user defined function then pop its local vars.
    // otherwise delete the body token
@@ -90,6 +92,11 @@ const Function_PC pc = get_executable()->get_exec_ufun()->pc_for_line(new_line);
    Log(LOG_prefix_parser)   CERR << "GOTO [" << get_line() << "]" << endl;
 
    current_stack.reset(LOC);
+
+   // an operator waiting in the line that was left will never continue
+   //
+   delete eoc_handler;
+   eoc_handler = 0;
 }
 //----------------------------------------------------------------------------
 void
@@ -362,6 +369,27 @@ Token result = current_stack.reduce_statements();
    return result;
 }
 //----------------------------------------------------------------------------
+Token
+StateIndicator::call_eoc_handler(Token & result)
+{
+EOC_handler * handler = eoc_handler;
+   Assert(handler);
+   eoc_handler = 0;
+
+   try
+      {
+        Token ret = handler->resume(result);
+        if (ret.get_tag() == TOK_SI_PUSHED)   eoc_handler = handler;   // again
+        else                                  delete handler;
+        return ret;
+      }
+   catch (Error err)
+      {
+        delete handler;
+        return Token(TOK_ERROR, err.get_error_code());
+      }
+}
+//----------------------------------------------------------------------------
 void
 StateIndicator::unmark_all_values() const
 {
@@ -370,6 +398,7 @@ StateIndicator::unmark_all_values() const
 
    current_stack.unmark_all_values();   // values in the parsers
    fun_oper_cache.unmark_all_values();   // values in the derived function cache
+   if (eoc_handler)   eoc_handler->unmark_all_values();   // waiting operator
 }
 //----------------------------------------------------------------------------
 int
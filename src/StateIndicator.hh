@@ -30,6 +30,31 @@
 #include "Prefix.hh"
 #include "PrintOperator.hh"
 
+//----------------------------------------------------------------------------
+/**
+    A primitive operator that calls a defined function LO repeatedly
+    without an APL macro (e.g. LO/B). The operator calls LO and, if LO has
+    pushed an SI entry, installs an EOC_handler (end of context handler) in
+    the calling SI entry and returns TOK_SI_PUSHED. When LO returns, then
+    Command::finish_context() calls the EOC_handler with the result of LO
+    (instead of replacing the TOK_SI_PUSHED token of the calling SI entry
+    with it). The EOC_handler then calls LO again or returns the result of
+    the operator.
+ */
+/// The state of a primitive operator that waits for a defined function
+class EOC_handler
+{
+public:
+   /// destructor
+   virtual ~EOC_handler() {}
+
+   /// LO has returned \b result. Call LO again and return TOK_SI_PUSHED,
+   /// or else return the result of the operator.
+   virtual Token resume(Token & result) = 0;
+
+   /// clear the marked bit of the values used by \b this handler
+   virtual void unmark_all_values() const = 0;
+};
 //----------------------------------------------------------------------------
 /**
     One entry of the state indicator (SI) of the APL interpreter.
@@ -182,6 +207,20 @@ public:
    StateIndicator * get_parent() const
       { return parent; }
 
+   /// return the operator (if any) that waits for the SI entry that
+   /// \b this SI entry has pushed
+   const EOC_handler * get_eoc_handler() const
+      { return eoc_handler; }
+
+   /// let \b handler wait for the SI entry that \b this SI entry has
+   /// pushed. \b this SI entry then owns (and eventually deletes) \b handler
+   void set_eoc_handler(EOC_handler * handler)
+      { Assert(eoc_handler == 0);   eoc_handler = handler; }
+
+   /// the SI entry pushed by \b this SI entry has returned \b result. Let
+   /// the operator waiting for it continue and return its result
+   Token call_eoc_handler(Token & result);
+
    /// return the child SI (if any) that \b parent has called
    static const StateIndicator * find_child(const StateIndicator * parent);
 
@@ -212,6 +251,9 @@ protected:
 
    /// the StateIndicator that has called this one
    StateIndicator * parent;
+
+   /// the operator (if any) that waits for the SI entry pushed by this one
+   EOC_handler * eoc_handler;
 };
 //----------------------------------------------------------------------------
 
@@ -57,6 +57,7 @@ public:
    void set_apl_value(Value_P new_value)
       {
         name_class = NC_VARIABLE;
+        new_value->clear_temp();   // no longer a temporary value
         apl_val = new_value;
       }
 
@@ -146,7 +147,7 @@ protected:
    : apl_val(val),
      name_class(NC_VARIABLE),
      flags(VSF_NONE)
-   {}
+   { if (+apl_val)   apl_val->clear_temp(); }
 
    /// constructor: ValueStackItem for a shared variable
    ValueStackItem(SV_key key)
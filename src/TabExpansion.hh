@@ -60,6 +60,7 @@ enum ExpandHint
    EH_SYMBOLS,        ///< symbol names...
    EH_oCLEAR,         ///< optional CLEAR
    EH_oCLEAR_SAVE,    ///< optional CLEAR or SAVE
+   EH_oSAVE,          ///< optional SAVE
    EH_HOSTCMD,        ///< host command
    EH_UCOMMAND,       ///< user-defined command
    EH_COUNT,          ///< count
@@ -23,6 +23,7 @@
 
 #include "Common.hh"
 #include "Parallel.hh"
+#include "Performance.hh"
 #include "SystemVariable.hh"
 #include "Thread_context.hh"
 #include "UserPreferences.hh"
@@ -35,6 +36,12 @@ CoreCount Thread_context::thread_contexts_count = CCNT_0;
 Thread_context::PoolFunction * Thread_context::do_work =
     &Thread_context::PF_no_work;
 volatile _Atomic_word Thread_context::busy_worker_count = 0;
+volatile _Atomic_word Thread_context::parked_count = 0;
+pthread_mutex_t Thread_context::park_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t Thread_context::park_cond = PTHREAD_COND_INITIALIZER;
+volatile uint64_t Thread_context::fork_cycles = 0;
+CoreCount Thread_context::work_cores = CCNT_1;
+ShapeItem Thread_context::chunk_len = 1;
 
 //============================================================================
 Thread_context::Thread_context()
@@ -42,7 +49,13 @@ Thread_context::Thread_context()
      thread(0),
      job_number(0),
      job_name("no-job-name"),
-     blocked(false)
+     blocked(false),
+     parked(false),
+     work_from(0),
+     work_to(0),
+     work_lock(0),
+     wake_cycles(0),
+     woke_parked(false)
 {
 }
 //----------------------------------------------------------------------------
@@ -82,6 +95,7 @@ Thread_context::print_all(ostream & out)
         PRINT_LOCKED(
            out << "thread_contexts_count: " << thread_contexts_count << endl
                << "busy_worker_count:     " << busy_worker_count     << endl
+               << "parked_count:          " << parked_count          << endl
                << "active_core_count:     " << active_core_count     << endl;
 
            loop(e, thread_contexts_count)   thread_contexts[e].print(out);
@@ -95,7 +109,7 @@ Thread_context::print(ostream & out) const
 const void * vpth = reinterpret_cast<const void *>(thread);
 
    out << "thread #"     << setw(2) << N << ":" << setw(16) << vpth
-       << (blocked ? " BLKD" : " RUN ")
+       << (blocked ? " BLKD" : parked ? " PARK" : " RUN ")
        << " job:"        << setw(5) << int(job_number)
        << " " << job_name << endl;
 }
@@ -137,6 +151,161 @@ Thread_context::PF_lock_unlock_pool(Thread_context & tctx)
       }
 }
 
+//----------------------------------------------------------------------------
+void
+Thread_context::PF_park()
+{
+   pthread_mutex_lock(&park_mutex);
+   atomic_add(parked_count, 1);
+
+   // make parked_count visible before looking at job_number (the master
+   // increases job_number before it looks at parked_count).
+   __sync_synchronize();
+
+   parked = true;
+   while (get_master().job_number == job_number)
+         pthread_cond_wait(&park_cond, &park_mutex);
+   parked = false;
+
+   atomic_add(parked_count, -1);
+   pthread_mutex_unlock(&park_mutex);
+
+#ifdef PERFORMANCE_COUNTERS_WANTED
+   wake_cycles = cycle_counter() - fork_cycles;
+   woke_parked = true;
+#endif
+}
+//----------------------------------------------------------------------------
+void
+Thread_context::M_wake_parked()
+{
+   pthread_mutex_lock(&park_mutex);
+   pthread_cond_broadcast(&park_cond);
+   pthread_mutex_unlock(&park_mutex);
+}
+//----------------------------------------------------------------------------
+void
+Thread_context::M_distribute_work(ShapeItem len, CoreCount cores)
+{
+   work_cores = cores;
+   chunk_len = len / (cores * CHUNKS_PER_CORE);
+   if (chunk_len < 1)   chunk_len = 1;
+
+const ShapeItem slice_len = (len + cores - 1) / cores;
+   loop(c, cores)
+      {
+        Thread_context & tctx = thread_contexts[c];
+        tctx.work_from = c * slice_len;
+        tctx.work_to   = tctx.work_from + slice_len;
+        if (tctx.work_to   > len)           tctx.work_to = len;
+        if (tctx.work_from > tctx.work_to)  tctx.work_from = tctx.work_to;
+      }
+
+   // M_fork() starts all active cores, not only the first cores. Empty the
+   // ranges of the others, which may still hold the rest of a job that was
+   // abandoned after an error.
+   //
+   for (int c = cores; c < active_core_count; ++c)
+       {
+         Thread_context & tctx = thread_contexts[c];
+         tctx.work_from = 0;
+         tctx.work_to   = 0;
+       }
+}
+//----------------------------------------------------------------------------
+bool
+Thread_context::PF_next_chunk(ShapeItem & from, ShapeItem & to)
+{
+   // cores beyond work_cores do not take part in the job (callers may
+   // have per-core state only for the first work_cores cores)
+   //
+   if (int(N) >= int(work_cores))   return false;
+
+   for (;;)
+       {
+         Parallel::acquire_lock(work_lock);
+         if (work_from < work_to)   // own work left
+            {
+              from = work_from;
+              to = from + chunk_len;
+              if (to > work_to)   to = work_to;
+              work_from = to;
+              Parallel::release_lock(work_lock);
+              return true;
+            }
+         Parallel::release_lock(work_lock);
+
+         if (!PF_steal_work())   return false;   // all work done
+       }
+}
+//----------------------------------------------------------------------------
+bool
+Thread_context::PF_steal_work()
+{
+   // find the core with the most work left. The range found is only a
+   // hint (its owner may claim from it meanwhile), so it is checked again
+   // below when the work is actually stolen.
+   //
+Thread_context * victim = 0;
+ShapeItem victim_left = 0;
+   loop(c, work_cores)
+      {
+        Thread_context & tctx = thread_contexts[c];
+        if (&tctx == this)   continue;
+        Parallel::acquire_lock(tctx.work_lock);
+        const ShapeItem left = tctx.work_to - tctx.work_from;
+        Parallel::release_lock(tctx.work_lock);
+        if (left > victim_left)
+           {
+             victim = &tctx;
+             victim_left = left;
+           }
+      }
+
+   if (victim == 0)   return false;
+
+   Parallel::acquire_lock(victim->work_lock);
+const ShapeItem left = victim->work_to - victim->work_from;
+   if (left <= 0)   // victim has finished meanwhile: try again
+      {
+        Parallel::release_lock(victim->work_lock);
+        return true;
+      }
+
+   // take the back half (rounded up) of the victim's range
+   //
+const ShapeItem steal_from = victim->work_to - (left + 1) / 2;
+const ShapeItem steal_to = victim->work_to;
+   victim->work_to = steal_from;
+   Parallel::release_lock(victim->work_lock);
+
+   Parallel::acquire_lock(work_lock);
+   work_from = steal_from;
+   work_to = steal_to;
+   Parallel::release_lock(work_lock);
+   return true;
+}
+//----------------------------------------------------------------------------
+void
+Thread_context::M_collect_wake_cycles()
+{
+#ifdef PERFORMANCE_COUNTERS_WANTED
+   // called by the master after all workers have joined, so the workers
+   // do not touch their wake_cycles while we read them.
+   //
+   for (int w = 1; w < active_core_count; ++w)
+       {
+         Thread_context & tctx = thread_contexts[w];
+         if (tctx.wake_cycles == 0)   continue;   // not woken (yet)
+
+         if (tctx.woke_parked)
+            Performance::fs_wake_park_B.add_sample(tctx.wake_cycles, 1);
+         else
+            Performance::fs_wake_spin_B.add_sample(tctx.wake_cycles, 1);
+         tctx.wake_cycles = 0;
+       }
+#endif
+}
 //----------------------------------------------------------------------------
 void Thread_context::set_active_core_count(CoreCount new_count)
 {
@@ -33,16 +33,16 @@
   while (worker-) threads 1 ... are only activated when some parallel work
   is available.
 
-  The worker threads 1... are either working, or busy-waiting for work, or
+  The worker threads 1... are either working, or waiting for work, or
   blocked on a semaphore:
 
          init
           ↓
-       blocked ←→ busy-waiting ←→ working
+       blocked ←→ waiting ←→ working
 
   The transitions
 
-      blocked ←→ busy-waiting
+      blocked ←→ waiting
 
   occur before and after the master thread waits for terminal input or when
   the number of cores is being changed (with ⎕SYL[26;2]). The workers are
@@ -52,12 +52,27 @@
 
   The transitions
 
-        busy-waiting ←→ working
+        waiting ←→ working
 
   occurs when the execution of APL primitives, primarily scalar functions,
   suggests to execute in parallel (i.e. if the vectors involved are
   sufficiently long).
 
+  A waiting worker first busy-waits (spins) for PF_SPIN_COUNT polls of the
+  master's job_number and then parks itself on park_cond. This keeps the
+  wake-up latency of back-to-back jobs low, but also stops idle workers from
+  burning their cores in processes that never wait for terminal input (and
+  therefore never block the pool). The master signals park_cond in M_fork()
+  only if some worker is actually parked.
+
+  The items of a parallel job are distributed over the cores by a simple
+  work-stealing scheduler: M_distribute_work() gives every core an equal
+  range of items, and every core then claims chunks from the front of its
+  own range with PF_next_chunk(). A core whose range is exhausted steals the
+  back half of the largest remaining range of another core. That keeps all
+  cores busy even if the cost of the items varies (nested items, expensive
+  cell functions like ! or ○, or mixed data).
+
  **/
 //============================================================================
 /// the context for one parallel execution thread
@@ -83,20 +98,44 @@ public:
       {
         get_master().job_name = jname;
         atomic_add(busy_worker_count, active_core_count - 1);
+#ifdef PERFORMANCE_COUNTERS_WANTED
+        fork_cycles = cycle_counter();
+#endif
         ++get_master().job_number;
+
+        // make the new job_number visible before looking at parked_count
+        // (a worker increments parked_count before it checks job_number).
+        __sync_synchronize();
+        if (atomic_read(parked_count))   M_wake_parked();
       }
 
    /// start parallel execution of work in a worker
    void PF_fork()
       {
-        while (get_master().job_number == job_number)
-              /* busy wait until the master has increased job_number */ ;
+        // spin for a while, then park until the master increases job_number
+        //
+        for (int spin = 0; spin < PF_SPIN_COUNT; ++spin)
+            {
+              if (get_master().job_number != job_number)
+                 {
+#ifdef PERFORMANCE_COUNTERS_WANTED
+                   wake_cycles = cycle_counter() - fork_cycles;
+                   woke_parked = false;
+#endif
+                   return;
+                 }
+            }
+
+        PF_park();
       }
 
    /// end parallel execution of work at the master
    static void M_join()
       {
         while (atomic_read(busy_worker_count) != 0)   /* busy wait */ ;
+#ifdef PERFORMANCE_COUNTERS_WANTED
+        M_collect_wake_cycles();
+#endif
       }
 
    /// end parallel execution of work in a worker
@@ -111,6 +150,15 @@ public:
               /* busy wait */ ;
       }
 
+   /// distribute the items 0 ... \b len-1 of a job evenly over the first
+   /// \b cores cores (and no items to the other active cores)
+   static void M_distribute_work(ShapeItem len, CoreCount cores);
+
+   /// claim the next chunk [\b from, \b to) of the current job, stealing
+   /// from other cores if needed. Return false if no work is left or if
+   /// this core is not one of the cores of the job.
+   bool PF_next_chunk(ShapeItem & from, ShapeItem & to);
+
    /// bind thread to core
    void bind_to_cpu(CPU_Number cpu, bool logit);
 
@@ -152,6 +200,12 @@ public:
    /// block/unblock on the pool semaphore
    static PoolFunction PF_lock_unlock_pool;
 
+   /// the number of polls of job_number before a waiting worker parks itself
+   enum { PF_SPIN_COUNT = 50000 };
+
+   /// the number of chunks into which the range of every core is divided
+   enum { CHUNKS_PER_CORE = 8 };
+
    /// number of currently used cores
    static CoreCount get_active_core_count()
       { return active_core_count; }
@@ -166,6 +220,19 @@ protected:
    /// initialize thread_contexts[n]
    void init_entry(CoreNumber n);
 
+   /// wait on park_cond until the master increases job_number
+   void PF_park();
+
+   /// steal the back half of the largest range of another core.
+   /// Return false if no other core has work left.
+   bool PF_steal_work();
+
+   /// wake up all workers that are parked on park_cond
+   static void M_wake_parked();
+
+   /// add the wake-up latencies of the last job to the statistics
+   static void M_collect_wake_cycles();
+
    /// the cpu core to which this thread is bound
    CPU_Number CPU;
 
@@ -188,6 +255,24 @@ public:
    /// true if blocked on pool_sema
    bool blocked;
 
+   /// true if parked on park_cond
+   volatile bool parked;
+
+   /// the first item of the current job not yet claimed by this core
+   volatile ShapeItem work_from;
+
+   /// the end of the items of the current job owned by this core
+   volatile ShapeItem work_to;
+
+   /// a lock protecting work_from and work_to
+   volatile _Atomic_word work_lock;
+
+   /// the cycles between M_fork() and the end of PF_fork()
+   volatile uint64_t wake_cycles;
+
+   /// true if the last PF_fork() was ended from park_cond
+   bool woke_parked;
+
    /// a list of monadic PJobs created by this core
    Parallel_job_list<PJob_scalar_B, false> joblist_B;
 
@@ -223,6 +308,24 @@ protected:
 
    /// the number of cores currently used
    static CoreCount active_core_count;
+
+   /// the number of workers parked (or about to park) on park_cond
+   static volatile _Atomic_word parked_count;
+
+   /// the mutex protecting park_cond
+   static pthread_mutex_t park_mutex;
+
+   /// the condition variable on which waiting workers are parked
+   static pthread_cond_t park_cond;
+
+   /// cycle_counter() at the last M_fork()
+   static volatile uint64_t fork_cycles;
+
+   /// the number of cores working on the current job
+   static CoreCount work_cores;
+
+   /// the number of items claimed at once by PF_next_chunk()
+   static ShapeItem chunk_len;
 };
 //============================================================================
 
@@ -22,10 +22,19 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
 
 #include "buildtag.hh"
 
+#include "Bif_F12_INTERVAL_INDEX.hh"
+#include "Bif_F12_SORT.hh"
+#include "Bif_OPER1_REDUCE.hh"
+#include "Bif_OPER1_SCAN.hh"
 #include "Bif_OPER2_INNER.hh"
 #include "Bif_OPER2_OUTER.hh"
 #include "Common.hh"
@@ -34,6 +43,7 @@
 #include "LibPaths.hh"
 #include "Output.hh"
 #include "ScalarFunction.hh"
+#include "Thread_context.hh"
 #include "UserPreferences.hh"
 #include "Workspace.hh"
 
@@ -1566,11 +1576,14 @@ UserPreferences::decode_ASCII(const char * strg)
 }
 //----------------------------------------------------------------------------
 void
-UserPreferences::read_threshold_file(bool sys, bool log_startup)
+UserPreferences::read_threshold_file(bool sys, bool this_host,
+                                     bool log_startup)
 {
 char filename[APL_PATH_MAX + 1];
 
-FILE * f = open_user_file("parallel_thresholds", filename, sys, log_startup);
+const UTF8_string fname = this_host ? host_threshold_file()
+                                    : UTF8_string("parallel_thresholds");
+FILE * f = open_user_file(fname.c_str(), filename, sys, log_startup);
    if (f == 0)   return;
 
 int line = 0;
@@ -1628,8 +1641,10 @@ int line = 0;
            const ShapeItem value = strtoll(p_be, 0, 0);
 
          enum { _B = 1, _AB = 2 };
-#define perfo_1(bif, ab, _name, th)   if (!strncmp(param, #bif, strlen(#bif))) \
-   set_threshold(Bif_ ## bif::fun, ab, i_ab, value);
+#define perfo_1(bif, ab, _name, th)                      \
+   if (!strncmp(param, #bif, strlen(#bif)) &&             \
+       (param[strlen(#bif)] == ',' || param[strlen(#bif)] <= ' ')) \
+      set_threshold(Bif_ ## bif::fun, ab, i_ab, value);
 
 #define perfo_2(bif, ab, _name, thr)  perfo_1(bif, ab, _name, thr)
 #define perfo_3(bif, ab, _name, thr)  perfo_1(bif, ab, _name, thr)
@@ -1645,6 +1660,74 @@ int line = 0;
        }
 }
 //----------------------------------------------------------------------------
+UTF8_string
+UserPreferences::host_threshold_file()
+{
+char hostname[256] = "localhost";
+   gethostname(hostname, sizeof(hostname) - 1);
+   hostname[sizeof(hostname) - 1] = 0;
+
+UTF8_string ret("parallel_thresholds_");
+   ret.append_UTF8(hostname);
+   return ret;
+}
+//----------------------------------------------------------------------------
+void
+UserPreferences::write_threshold_file(ostream & out)
+{
+const char * HOME = getenv("HOME");
+   if (HOME == 0)
+      {
+        out << "environment variable 'HOME' is not defined!" << endl;
+        return;
+      }
+
+   // like open_user_file(): use $HOME/.gnu-apl if it exists, or else
+   // $HOME/.config/gnu-apl (which is created if needed).
+   //
+UTF8_string dirname(HOME);
+   dirname.append_UTF8("/.gnu-apl");
+   if (access(dirname.c_str(), F_OK) != 0)   // no $HOME/.gnu-apl
+      {
+        dirname = UTF8_string(HOME);
+        dirname.append_UTF8("/.config");
+        mkdir(dirname.c_str(), 0755);
+        dirname.append_UTF8("/gnu-apl");
+        mkdir(dirname.c_str(), 0755);
+      }
+
+UTF8_string filename(dirname);
+   filename.append_UTF8("/");
+   filename.append_UTF8(host_threshold_file());
+
+ofstream outf(filename.c_str(), ofstream::out);
+   if (!outf.is_open())
+      {
+        out << "opening " << filename
+            << " failed: " << strerror(errno) << endl;
+        return;
+      }
+
+   outf << "# parallel thresholds for this host and "
+        << Thread_context::get_active_core_count() << " cores," << endl
+        << "# written by ]PCAL SAVE and read at start-up." << endl
+        << "#" << endl;
+
+enum { _B = 1, _AB = 2 };
+#define perfo_1(bif, ab, name, _thr)                                      \
+   outf << "perfo_" << ab << "(" << left << setw(14) << #bif << ", "     \
+        << (ab == _B ? "_B, " : "_AB,") << " \"" << name << "\", "      \
+        << right << (ab == _B ? Bif_ ## bif::fun->get_monadic_threshold() \
+                              : Bif_ ## bif::fun->get_dyadic_threshold()) \
+        << ")" << endl;
+#define perfo_2(bif, ab, name, thr)   perfo_1(bif, ab, name, thr)
+#define perfo_3(bif, ab, name, thr)
+#define perfo_4(bif, ab, name, thr)
+#include "Performance.def"
+
+   out << "Parallel thresholds written to file " << filename << endl;
+}
+//----------------------------------------------------------------------------
 void
 UserPreferences::set_threshold(Function_P fun, int ab, int i_ab,
                                ShapeItem threshold)
@@ -81,8 +81,15 @@ struct UserPreferences
    /// read a \b preference file and update parameters set there
    void read_config_file(bool sys, bool log_startup);
 
-   /// read a \b parallel_thresholds file and update parameters set there
-   void read_threshold_file(bool sys, bool log_startup);
+   /// read a \b parallel_thresholds file (or, if \b this_host is \b true,
+   /// the file written by write_threshold_file()) and update parameters set
+   /// there
+   void read_threshold_file(bool sys, bool this_host, bool log_startup);
+
+   /// write the current parallel thresholds of all scalar functions into
+   /// the file parallel_thresholds_<hostname> in $HOME/.config/gnu-apl
+   /// (or in $HOME/.gnu-apl if that directory exists)
+   void write_threshold_file(ostream & out);
 
    /// print possible command line options and exit
    static void usage(const char * prog);
@@ -264,6 +271,9 @@ protected:
    /// and starts with #!
    static bool is_APL_script(const char * filename);
 
+   /// return the name of the parallel_thresholds file for this host
+   static UTF8_string host_threshold_file();
+
    /// open a user-supplied config file (in $HOME or gnu-apl.d)
    FILE * open_user_file(const char * fname, char * opened_filename,
                          bool sys, bool log_startup);
@@ -39,6 +39,7 @@
 #include "Parallel.hh"
 #include "PrintOperator.hh"
 #include "Quad_XML.hh"
+#include "SearchIndex.hh"
 #include "SystemVariable.hh"
 #include "UCS_string.hh"
 #include "UserFunction.hh"
@@ -74,6 +75,7 @@ Value::init_ravel()
    check_ptr = 0;
    IntCell::z0(short_value);
    ravel = short_value;
+   search_cache = 0;
 
    ++value_count;
    if (Quad_SYL::value_count_limit &&
@@ -299,16 +301,19 @@ Value::Value(const Shape & sh, const char * loc)
 Value::Value(const Shape & sh, uint64_t * bits, const char * loc)
    : DynamicObject(loc, &all_values),
      shape(sh),
-     fetcher(&packed_fetcher),
+     fetcher(&typed_fetcher),
      owner_count(0),
      pointer_cell_count(0),
-     flags(VF_packed),
+     flags(VF_packed | VF_complete),
      valid_ravel_items(sh.get_nz_volume()),
      nz_subcell_count(0),
-     ravel(reinterpret_cast<Cell *>(bits))
+     ravel(reinterpret_cast<Cell *>(bits)),
+     search_cache(0)
 {
    ADD_EVENT(this, VHE_Create, 0, loc);
    check_ptr = charP(this) + 7;
+   ++value_count;
+   total_ravel_count += typed_cell_count();
 
    if (ravel)   return;   // caller has allocated 
 
@@ -317,7 +322,66 @@ const size_t uint64_count = (sh.get_nz_volume() + 63) >> 6;
    bits = new uint64_t[uint64_count];
    loop(u, uint64_count)   bits[u] = 0;
    ravel = reinterpret_cast<Cell *>(bits);
-   set_complete();
+}
+//----------------------------------------------------------------------------
+Value::Value(const Shape & sh, APL_Integer * ints, const char * loc)
+   : DynamicObject(loc, &all_values),
+     shape(sh),
+     fetcher(&typed_fetcher),
+     owner_count(0),
+     pointer_cell_count(0),
+     flags(VF_ints | VF_complete),
+     valid_ravel_items(sh.get_volume()),
+     nz_subcell_count(0),
+     ravel(reinterpret_cast<Cell *>(ints)),
+     search_cache(0)
+{
+   Assert(ints);
+   Assert(sh.get_volume() >= TYPED_MINIMUM_LENGTH);
+   ADD_EVENT(this, VHE_Create, 0, loc);
+   check_ptr = charP(this) + 7;
+   ++value_count;
+   total_ravel_count += typed_cell_count();
+}
+//----------------------------------------------------------------------------
+Value::Value(const Shape & sh, APL_Float * reals, const char * loc)
+   : DynamicObject(loc, &all_values),
+     shape(sh),
+     fetcher(&typed_fetcher),
+     owner_count(0),
+     pointer_cell_count(0),
+     flags(VF_floats | VF_complete),
+     valid_ravel_items(sh.get_volume()),
+     nz_subcell_count(0),
+     ravel(reinterpret_cast<Cell *>(reals)),
+     search_cache(0)
+{
+   Assert(reals);
+   Assert(sh.get_volume() >= TYPED_MINIMUM_LENGTH);
+   ADD_EVENT(this, VHE_Create, 0, loc);
+   check_ptr = charP(this) + 7;
+   ++value_count;
+   total_ravel_count += typed_cell_count();
+}
+//----------------------------------------------------------------------------
+Value::Value(const Shape & sh, Unicode * chars, const char * loc)
+   : DynamicObject(loc, &all_values),
+     shape(sh),
+     fetcher(&typed_fetcher),
+     owner_count(0),
+     pointer_cell_count(0),
+     flags(VF_chars | VF_complete),
+     valid_ravel_items(sh.get_volume()),
+     nz_subcell_count(0),
+     ravel(reinterpret_cast<Cell *>(chars)),
+     search_cache(0)
+{
+   Assert(chars);
+   Assert(sh.get_volume() >= TYPED_MINIMUM_LENGTH);
+   ADD_EVENT(this, VHE_Create, 0, loc);
+   check_ptr = charP(this) + 7;
+   ++value_count;
+   total_ravel_count += typed_cell_count();
 }
 //----------------------------------------------------------------------------
 Value::Value(const UCS_string & ucs, const char * loc)
@@ -402,11 +466,13 @@ Value::~Value()
 {
    ADD_EVENT(this, VHE_Destruct, 0, LOC);
    unlink();
+   if (search_cache)   drop_search_cache();
 
-   if (flags & VF_packed)
+   if (flags & VF_typed)
       {
-        uint8_t * bits = reinterpret_cast<uint8_t *>(ravel);
-        delete[] bits;
+        --value_count;
+        total_ravel_count -= typed_cell_count();
+        delete_typed_ravel();
         ravel = 0;
         Assert(check_ptr == charP(this) + 7);
         check_ptr = 0;
@@ -992,9 +1058,11 @@ Value::get_new_member(const UCS_string & new_member_name)
 void
 Value::double_ravel(const char * loc)
 {
+   Assert(is_member());
+   Assert(!is_typed());
+   if (search_cache)   drop_search_cache();
 Cell * const old_ravel = ravel;
 
-   Assert(is_member());
 const char * del = 0;
    if (ravel != short_value)   del = reinterpret_cast<char *>(ravel);
 
@@ -1155,7 +1223,7 @@ void
 Value::unmark() const
 {
    clear_marked();
-   if (is_packed())   return;
+   if (is_typed())   return;   // no sub-values
 
 const ShapeItem ec = nz_element_count();
 const Cell * C = &get_cfirst();
@@ -1260,6 +1328,9 @@ Value::list_one(ostream & out, bool show_owners) const
         if (is_complete())   { out << sep << "COMPLETE";   sep = '+'; }
         if (is_marked())     { out << sep << "MARKED";     sep = '+'; }
         if (is_packed())     { out << sep << "PACKED";     sep = '+'; }
+        if (flags & VF_ints)     { out << sep << "INTS";     sep = '+'; }
+        if (flags & VF_floats)   { out << sep << "FLOATS";   sep = '+'; }
+        if (flags & VF_chars)    { out << sep << "CHARS";    sep = '+'; }
       }
    else
       {
@@ -1300,6 +1371,8 @@ ShapeItem
 Value::get_enlist_count() const
 {
 const ShapeItem ec = element_count();
+   if (is_typed())   return ec;   // simple
+
 ShapeItem count = ec;
 
    loop(c, ec)
@@ -1422,6 +1495,8 @@ Value::is_apl_char_vector() const
 bool
 Value::is_char_array() const
 {
+   if (flags & VF_typed)   return (flags & VF_chars) != 0;
+
 const Cell * C = &get_cfirst();
    loop(c, nz_element_count())   // also check prototype
       if (!C++->is_character_cell())   return false;   // not char
@@ -1431,6 +1506,8 @@ const Cell * C = &get_cfirst();
 bool
 Value::NOTCHAR() const
 {
+   if (flags & VF_typed)   return !(flags & VF_chars);
+
    // always test element 0.
    if (!get_cfirst().is_character_cell())   return true;
 
@@ -1446,6 +1523,14 @@ bool
 Value::is_int_array() const
 {
 const ShapeItem ec = nz_element_count();
+   if (flags & (VF_ints | VF_packed))   return true;
+   if (flags & VF_chars)                return false;
+   if (const APL_Float * reals = get_float_ravel())
+      {
+        loop(r, ec)   if (!Cell::is_near_int(reals[r]))   return false;
+        return true;
+      }
+
    loop(c, ec)
        {
          if (!get_cravel(c).is_near_int())   return false;
@@ -1457,6 +1542,13 @@ const ShapeItem ec = nz_element_count();
 bool
 Value::is_complex(bool check_numeric) const
 {
+   if (flags & VF_chars)
+      {
+        if (check_numeric)    DOMAIN_ERROR;
+        return false;
+      }
+   if (flags & VF_typed)   return false;   // int or real
+
 const ShapeItem ec = nz_element_count();
 
    loop(e, ec)
@@ -1476,6 +1568,8 @@ const ShapeItem ec = nz_element_count();
 bool
 Value::can_be_compared() const
 {
+   if (flags & VF_typed)   return true;   // char, int, or real
+
 const ShapeItem count = nz_element_count();
    loop(c, count)
       {
@@ -1514,7 +1608,7 @@ Value::equal_string(const UCS_string & ucs) const
 bool
 Value::is_simple() const
 {
-   if (flags & VF_packed)   return true;
+   if (flags & VF_typed)   return true;
 
 const ShapeItem count = element_count();
 const Cell * C = &get_cfirst();
@@ -1536,6 +1630,7 @@ Value::is_one_dimensional() const
    // That is wrong, however
    //
    if (get_rank() > 1)   return false;
+   if (is_typed())       return true;   // no sub-values
 
 const ShapeItem count = nz_element_count();
 const Cell * C = &get_cfirst();
@@ -1569,6 +1664,8 @@ Value::compute_depth() const
         return 0;
       }
 
+   if (is_typed())   return 1;   // simple non-scalar
+
 const ShapeItem count = nz_element_count();
 
 APL_types::Depth sub_depth = 0;
@@ -1586,8 +1683,18 @@ APL_types::Depth sub_depth = 0;
 }
 //----------------------------------------------------------------------------
 CellType
+Value::typed_cell_type() const
+{
+   if (flags & VF_chars)    return CT_CHAR;
+   if (flags & VF_floats)   return CT_FLOAT;
+   return CT_INT;   // VF_ints or VF_packed
+}
+//----------------------------------------------------------------------------
+CellType
 Value::flat_cell_types() const
 {
+   if (is_typed())   return typed_cell_type();
+
 int32_t ctypes = 0;
 
 const ShapeItem count = nz_element_count();
@@ -1610,6 +1717,8 @@ const ShapeItem count = nz_element_count();
 CellType
 Value::deep_cell_types() const
 {
+   if (is_typed())   return typed_cell_type();
+
 int32_t ctypes = 0;
 
 const ShapeItem count = nz_element_count();
@@ -2069,6 +2178,14 @@ Value::check_value(const char * loc)
 {
 #ifdef VALUE_CHECK_WANTED
 
+   // typed ravels are complete (and correct) by construction
+   //
+   if (flags & VF_typed)
+      {
+        set_complete();
+        return;
+      }
+
    // if value was initialized by means of a next_ravel_XXX() mechanism,
    // then all cells are supposed to be OK.
    //
@@ -2432,6 +2549,9 @@ UCS_string ind(indent, UNI_SPACE);
         if (is_marked())      out << " VF_marked";
         if (is_member())      out << " VF_member";
         if (is_packed())      out << " VF_packed";
+        if (flags & VF_ints)     out << " VF_ints";
+        if (flags & VF_floats)   out << " VF_floats";
+        if (flags & VF_chars)    out << " VF_chars";
         out << endl
              << ind << "First:   " << get_cfirst()  << endl
              << ind << "Dynamic: ";
@@ -2529,6 +2649,8 @@ Value::clone(const char * loc) const
 const uint64_t start_1 = cycle_counter();
 #endif
 
+   if (is_typed())   return clone_typed(loc);
+
 Value_P Z(get_shape(), loc);
    Z->flags |= flags & VF_member;   // propagate member flag
 
@@ -2556,6 +2678,38 @@ const uint64_t count1 = nz_element_count();
    return Z;
 }
 //----------------------------------------------------------------------------
+/// return a new value with shape \b shape and a copy of the \b len items of
+/// the typed ravel \b items
+template<typename T>
+static Value_P
+clone_typed_ravel(const Shape & shape, const T * items, ShapeItem len,
+                  const char * loc)
+{
+T * items_Z = Value::new_typed_ravel<T>(len, loc);
+   loop(l, len)   items_Z[l] = items[l];
+
+   try           { return Value_P(shape, items_Z, loc); }
+   catch (...)   { delete[] items_Z;   throw; }
+}
+//----------------------------------------------------------------------------
+Value_P
+Value::clone_typed(const char * loc) const
+{
+const ShapeItem len = element_count();
+   if (const uint64_t * bits = get_packed_ravel())
+      return clone_typed_ravel(get_shape(), bits, (len + 63) >> 6, loc);
+
+   if (const APL_Integer * ints = get_int_ravel())
+      return clone_typed_ravel(get_shape(), ints, len, loc);
+
+   if (const APL_Float * reals = get_float_ravel())
+      return clone_typed_ravel(get_shape(), reals, len, loc);
+
+const Unicode * chars = get_char_ravel();
+   Assert(chars);
+   return clone_typed_ravel(get_shape(), chars, len, loc);
+}
+//----------------------------------------------------------------------------
 Value_P
 Value::prototype(const char * loc) const
 {
@@ -2830,25 +2984,104 @@ ShapeItem lval_count = 0;
    return errors;
 }
 //----------------------------------------------------------------------------
+ShapeItem
+Value::typed_cell_count() const
+{
+   // return the number of Cells that occupy (about) the same memory as the
+   // packed or typed ravel of this value (for ⎕WA and friends).
+   //
+const ShapeItem len = nz_element_count();
+ShapeItem bytes = 0;
+   if      (flags & VF_packed)   bytes = 8*((len + 63) >> 6);
+   else if (flags & VF_ints)     bytes = len * sizeof(APL_Integer);
+   else if (flags & VF_floats)   bytes = len * sizeof(APL_Float);
+   else if (flags & VF_chars)    bytes = len * sizeof(Unicode);
+
+   return (bytes + sizeof(Cell) - 1) / sizeof(Cell);
+}
+//----------------------------------------------------------------------------
+void
+Value::delete_typed_ravel()
+{
+   if      (flags & VF_packed)
+      delete[] reinterpret_cast<uint64_t *>(ravel);
+   else if (flags & VF_ints)
+      delete[] reinterpret_cast<APL_Integer *>(ravel);
+   else if (flags & VF_floats)
+      delete[] reinterpret_cast<APL_Float *>(ravel);
+   else if (flags & VF_chars)
+      delete[] reinterpret_cast<Unicode *>(ravel);
+}
+//----------------------------------------------------------------------------
+SearchCache &
+Value::get_search_cache() const
+{
+   if (search_cache == 0)   search_cache = new SearchCache(*this);
+   return *search_cache;
+}
+//----------------------------------------------------------------------------
+void
+Value::drop_search_cache() const
+{
+   delete search_cache;   // also releases its memory in total_ravel_count
+   search_cache = 0;
+}
+//----------------------------------------------------------------------------
 void
 Value::explode()
 {
-   Assert(is_packed());
-const uint8_t * bits = reinterpret_cast<const uint8_t *>(ravel);
+   if (!(flags & VF_typed))   return;   // already a Cell ravel
 
-IntCell * new_ravel = 0;
-   try           { ravel = new IntCell[element_count()]; }
-   catch (...)   { WS_FULL }
+const ShapeItem len = element_count();
+Cell * new_ravel = 0;
+   try           { new_ravel = reinterpret_cast<Cell *>
+                                          (new char[len * sizeof(Cell)]); }
+   catch (...)   { WS_FULL; }
 
-   loop(b, element_count())
-      if (bits[b >> 3] & 1 << (b & 7))   new_ravel[b].set_int_value(1);
+   if (const uint64_t * bits = get_packed_ravel())
+      {
+        loop(b, len)   IntCell::zI(new_ravel + b, (bits[b >> 6] >> (b & 63)) & 1);
+      }
+   else if (const APL_Integer * ints = get_int_ravel())
+      {
+        loop(i, len)   IntCell::zI(new_ravel + i, ints[i]);
+      }
+   else if (const APL_Float * reals = get_float_ravel())
+      {
+        loop(r, len)   FloatCell::zF(new_ravel + r, reals[r]);
+      }
+   else if (const Unicode * chars = get_char_ravel())
+      {
+        loop(c, len)   CharCell::zU(new_ravel + c, chars[c]);
+      }
+
+   total_ravel_count -= typed_cell_count();
+   total_ravel_count += len;
+   delete_typed_ravel();
 
-   delete [] bits;
    ravel = new_ravel;
-   clear_packed();
+   flags &= ~VF_typed;
    fetcher = &cell_fetcher;
 }
 //----------------------------------------------------------------------------
+const Cell &
+Value::get_cravel(ShapeItem idx, Cell * buffer) const
+{
+   Assert1(idx < nz_element_count());
+   if (!(flags & VF_typed))   return ravel[idx];
+
+   if (const uint64_t * bits = get_packed_ravel())
+      IntCell::zI(buffer, (bits[idx >> 6] >> (idx & 63)) & 1);
+   else if (const APL_Integer * ints = get_int_ravel())
+      IntCell::zI(buffer, ints[idx]);
+   else if (const APL_Float * reals = get_float_ravel())
+      FloatCell::zF(buffer, reals[idx]);
+   else
+      CharCell::zU(buffer, get_char_ravel()[idx]);
+
+   return *buffer;
+}
+//----------------------------------------------------------------------------
 const char *
 Value::try_implode()
 {
@@ -2898,14 +3131,43 @@ ShapeItem z = 0;
       }
    else
       {
-        if (ravel != short_value)   delete[] ravel;
+        if (ravel != short_value)   // long value
+           {
+             total_ravel_count -= element_count();
+             delete [] ravel;
+           }
         ravel = reinterpret_cast<Cell *>(bits);
         flags |= VF_packed;
+        fetcher = &typed_fetcher;
+        total_ravel_count += typed_cell_count();
       }
 
    return error_reason;
 }
 //----------------------------------------------------------------------------
+ShapeItem
+Value::count_packed_bits(const uint64_t * bits, ShapeItem from, ShapeItem len)
+{
+ShapeItem count = 0;
+
+   // single bits up to the next word boundary
+   //
+   for (; len && (from & 63); ++from, --len)
+       count += (bits[from >> 6] >> (from & 63)) & 1;
+
+   // full words
+   //
+   for (; len >= 64; from += 64, len -= 64)
+       count += __builtin_popcountll(bits[from >> 6]);
+
+   // single bits after the last full word
+   //
+   for (; len; ++from, --len)
+       count += (bits[from >> 6] >> (from & 63)) & 1;
+
+   return count;
+}
+//----------------------------------------------------------------------------
 ostream &
 operator<<(ostream & out, const Value & v)
 {
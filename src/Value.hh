@@ -37,6 +37,7 @@ class CDR_string;
 class Error;
 class IndexExpr;
 class PrintBuffer;
+class SearchCache;
 class Value_P;
 class Thread_context;
 
@@ -83,6 +84,18 @@ protected:
    /// the ravel (bits)
    Value(const Shape & sh, uint64_t * bits, const char * loc);
 
+   /// constructor: an integer array with shape \b sh and a typed ravel.
+   /// The caller has allocated (with new[]) and initialized the ravel (ints)
+   Value(const Shape & sh, APL_Integer * ints, const char * loc);
+
+   /// constructor: a real array with shape \b sh and a typed ravel.
+   /// The caller has allocated (with new[]) and initialized the ravel (reals)
+   Value(const Shape & sh, APL_Float * reals, const char * loc);
+
+   /// constructor: a character array with shape \b sh and a typed ravel.
+   /// The caller has allocated (with new[]) and initialized the ravel (chars)
+   Value(const Shape & sh, Unicode * chars, const char * loc);
+
    /// constructor: a simple character vector from a UCS string.
    /// Rank is always 1, so that is_char_vector() will be true.
    Value(const UCS_string & ucs, const char * loc);
@@ -106,6 +119,9 @@ public:
    /// packing makes no sense for short booleans
    enum { PACKED_MINIMUM_LENGHT = SHORT_VALUE_LENGTH_WANTED };
 
+   /// typed ravels make no sense for short values (which live in short_value)
+   enum { TYPED_MINIMUM_LENGTH = SHORT_VALUE_LENGTH_WANTED + 1 };
+
    /// return \b true iff \b this value is a scalar.
    bool is_scalar() const
       { return shape.get_rank() == 0; }
@@ -234,7 +250,7 @@ public:
 
    /// return the next byte after the ravel
    const Cell * get_ravel_end() const
-      { return &ravel[nz_element_count()]; }
+      { return &get_cfirst() + nz_element_count(); }
 
    /// return the integer of a value that is supposed to have (exactly) one
    APL_Integer get_sole_integer() const
@@ -245,7 +261,7 @@ public:
 
    /// return the first integer of a value (the line number of →Value).
    Function_Line get_line_number() const
-      { const APL_Integer line(ravel[0].get_near_int());
+      { const APL_Integer line(get_cfirst().get_near_int());
         Log(LOG_execute_goto)   CERR << "goto line " << line << endl;
         return Function_Line(line); }
 
@@ -321,13 +337,20 @@ public:
    /// double the ravel length of \b this value (by appending integer 0s).
    void double_ravel(const char * loc);
 
-   /// return the (constant) idx'th element of the ravel.
+   /// return the (constant) idx'th element of the ravel. NOTE: a typed
+   /// ravel is converted into Cells by this function, which is not
+   /// thread-safe (see typed_fetcher()).
    const Cell & get_cravel(ShapeItem idx) const
       {
         Assert1(idx < nz_element_count());
-        return fetcher(idx, ravel);
+        return fetcher(*this, idx);
       }
 
+   /// return the (constant) idx'th element of the ravel. Unlike get_cravel()
+   /// a packed or typed ravel is left as is; the Cell for its idx'th item
+   /// is constructed in \b buffer instead.
+   const Cell & get_cravel(ShapeItem idx, Cell * buffer) const;
+
    /// return the first element of the ravel (which is always present).
    /// same as get_cproto(), but named differently to indicate its context.
    const Cell & get_cfirst() const
@@ -345,7 +368,10 @@ public:
 
    /// return the (writable) idx'th element of the ravel.
    Cell & get_wravel(ShapeItem idx)
-      { Assert1(idx < nz_element_count());   return ravel[idx]; }
+      { Assert1(idx < nz_element_count());
+        if (search_cache)       drop_search_cache();
+        if (flags & VF_typed)   explode();
+        return ravel[idx]; }
 
    /// return the first element of the ravel (which is always present)
    /// Same as get_wproto() and get_wscalar(), but named differently
@@ -393,6 +419,9 @@ public:
    /// compute the cell types contained in the top level of \b this value
    CellType flat_cell_types() const;
 
+   /// return the CellType of the items of a packed or typed ravel
+   CellType typed_cell_type() const;
+
    /// compute the cell subtypes contained in the top level of \b this value
    CellType flat_cell_subtypes() const;
 
@@ -437,15 +466,21 @@ public:
    /// An elided index, for example B[], throws an INDEX_ERROR.
    static Shape to_shape(const Value * val);
    /// return the offset'th ravel cell (of an unpack'ed ravel)
-   static const Cell & cell_fetcher(ShapeItem offset, const Cell * ravel)
-      { return ravel[offset]; }
-
-   /// return the offset'th ravel cell (of an pack'ed ravel)
-   static const Cell & packed_fetcher(ShapeItem offset, const Cell * ravel)
-      { return 1 << (offset & 7) &
-               reinterpret_cast<const uint8_t *>(ravel)[offset >> 3]
-             ? IntCell::boolean_TRUE : IntCell::boolean_FALSE;
-      }
+   static const Cell & cell_fetcher(const Value & owner, ShapeItem offset)
+      { return owner.ravel[offset]; }
+
+   /// return the offset'th ravel cell of a packed or typed ravel. Code that
+   /// asks for Cells (as opposed to code that uses get_int_ravel() and
+   /// friends) may hold on to the Cell or walk the ravel from it, therefore
+   /// the ravel of \b owner is converted (once) to a Cell ravel.
+   ///
+   /// NOTE: the conversion modifies \b owner and is NOT thread-safe. Code
+   /// that reads Cells in a parallel job must convert its values in the
+   /// master before M_fork() (e.g. with explode() or get_cfirst()), or use
+   /// get_cravel(idx, buffer), which leaves the typed ravel as is.
+   static const Cell & typed_fetcher(const Value & owner, ShapeItem offset)
+      { const_cast<Value &>(owner).explode();
+        return owner.ravel[offset]; }
 
    /// glue two values.
    static void glue(Token & token, Token & token_A, Token & token_B,
@@ -541,9 +576,9 @@ public:
    /// initialize the next ravel cell with integer 1
    inline void next_ravel_1();
 
-   /// initialize the next ravel position with \b byte. NOTE that in this
-   /// case ravel is a uint8_t * and not a Cell * !!!
-   inline void next_ravel_Byte(uint8_t byte);
+   /// set the \b b'th byte of a packed ravel to \b byte. NOTE that in this
+   /// case ravel is a uint64_t * and not a Cell * !!!
+   inline void set_packed_byte(ShapeItem b, uint8_t byte);
 
    /// initialize the next ravel cell with a pointer to another Cell
    inline void next_ravel_Lval(Cell * target, Value * target_owner);
@@ -660,6 +695,27 @@ public:
 # define set_packed()   SET_packed(_LOC)
 # define clear_packed() CLEAR_packed(_LOC)
 
+   /// set the Value flag \b temp. It is set by the producer of a computed
+   /// value (see ScalarFunction::typed_scalar_AB()) and cleared when the
+   /// value is bound to a variable or becomes an item of another value.
+   /// While it is set, only the prefix that received the value holds it.
+   void SET_temp(_loc_type _loc) const
+      { FLAG_TRACE(temp, true)   flags |=  VF_temp;
+        ADD_EVENT(this, VHE_SetFlag, VF_temp, _loc); }
+
+   /// clear the Value flag \b temp
+   void CLEAR_temp(_loc_type _loc) const
+      { if (!(flags & VF_temp))   return;
+        FLAG_TRACE(temp, false)   flags &=  ~VF_temp;
+        ADD_EVENT(this, VHE_ClearFlag, VF_temp, _loc); }
+
+   /// true if Value flag \b temp is set
+   bool is_temp() const
+      { return (flags & VF_temp) != 0; }
+
+# define set_temp()   SET_temp(_LOC)
+# define clear_temp() CLEAR_temp(_LOC)
+
    /// set the Value flag \b complete
    void SET_complete(_loc_type _loc) const
       { FLAG_TRACE(complete, true)   flags |=  VF_complete;
@@ -798,9 +854,78 @@ public:
    /// print info related to a stale value
    void print_stale_info(ostream & out, const DynamicObject * dob) const;
 
-   /// expand this (packed) Boolean value (in place)
+   /// convert a packed or typed ravel of \b this value into a Cell ravel
+   /// (in place). Do nothing if the ravel of \b this value consists of Cells
    void explode();
 
+   /// allocate (with new[]) the typed ravel of a value with \b len items
+   /// of type \b T, or throw WS FULL.
+   template<typename T>
+   static T * new_typed_ravel(ShapeItem len, const char * loc)
+      {
+        const ShapeItem cells = (len*sizeof(T) + sizeof(Cell) - 1)/sizeof(Cell);
+        if (check_WS_FULL("new_typed_ravel()", cells, loc))   WS_FULL;
+        try           { return new T[len]; }
+        catch (...)   { WS_FULL; }
+      }
+
+   /// return \b true iff the ravel of \b this value is packed or typed,
+   /// i.e. does not (yet) consist of Cells.
+   bool is_typed() const
+      { return (flags & VF_typed) != 0; }
+
+   /// return the ravel of \b this value if it is a typed APL_Integer ravel,
+   /// or else 0
+   const APL_Integer * get_int_ravel() const
+      { return (flags & VF_ints) ? reinterpret_cast<const APL_Integer *>(ravel)
+                                 : 0; }
+
+   /// return the ravel of \b this value if it is a typed APL_Float ravel,
+   /// or else 0
+   const APL_Float * get_float_ravel() const
+      { return (flags & VF_floats) ? reinterpret_cast<const APL_Float *>(ravel)
+                                   : 0; }
+
+   /// return the writable ravel of \b this value if it is a typed
+   /// APL_Integer ravel, or else 0
+   APL_Integer * get_int_wravel()
+      { if (search_cache)   drop_search_cache();
+        return (flags & VF_ints) ? reinterpret_cast<APL_Integer *>(ravel) : 0; }
+
+   /// return the writable ravel of \b this value if it is a typed APL_Float
+   /// ravel, or else 0
+   APL_Float * get_float_wravel()
+      { if (search_cache)   drop_search_cache();
+        return (flags & VF_floats) ? reinterpret_cast<APL_Float *>(ravel) : 0; }
+
+   /// return the ravel of \b this value if it is a typed Unicode ravel,
+   /// or else 0
+   const Unicode * get_char_ravel() const
+      { return (flags & VF_chars) ? reinterpret_cast<const Unicode *>(ravel)
+                                  : 0; }
+
+   /// return the ravel of \b this value if it is a packed ravel, or else 0
+   const uint64_t * get_packed_ravel() const
+      { return (flags & VF_packed) ? reinterpret_cast<const uint64_t *>(ravel)
+                                   : 0; }
+
+   /// return the mask for the valid bits in the last word of a packed
+   /// ravel with \b len bits
+   static uint64_t packed_tail_mask(ShapeItem len)
+      { return (len & 63) ? (uint64_t(1) << (len & 63)) - 1 : ~uint64_t(0); }
+
+   /// return the number of 1-bits in the \b len bits of the packed ravel
+   /// \b bits starting at bit \b from
+   static ShapeItem count_packed_bits(const uint64_t * bits, ShapeItem from,
+                                      ShapeItem len);
+
+   /// return the search structures of \b this value (create them if needed).
+   /// They remain valid until \b this value is modified or deleted.
+   SearchCache & get_search_cache() const;
+
+   /// discard the search structures of \b this value (after modifying it)
+   void drop_search_cache() const;
+
    /// try to implode (pack) this unpacked value. Return 0 on success or
    /// reason on error;
    const char * try_implode();
@@ -891,28 +1016,28 @@ public:
    /// return a deep copy of \b this value
    Value_P clone(const char * loc) const;
 
+   /// return a copy of \b this value which has a packed or typed ravel
+   Value_P clone_typed(const char * loc) const;
+
 protected:
    /// return the next ravel cell to be initialized (excluding prototype)
    Cell * next_ravel()
       { return more() ? ravel + valid_ravel_items++ : 0; }
 
-   /// return the next (packed) byte position
-   uint8_t * next_ravel_byte()
-      {
-        Assert(is_packed());
-        if (!more())   return 0;   // no more valid items
-        return reinterpret_cast<uint8_t *>
-                               (ravel) + (valid_ravel_items++ >> 3);
-      }
-
    /// init the ravel of an APL value, return the ravel length
    inline void init_ravel();
 
+   /// return the number of Cells that a packed or typed ravel accounts for
+   ShapeItem typed_cell_count() const;
+
+   /// delete[] the packed or typed ravel of \b this value
+   void delete_typed_ravel();
+
    /// the shape of \b this value (only the first \b rank values are valid.
    Shape shape;
 
-   /// mux between packed and non-packed ravel cells
-   const Cell & (*fetcher)(ShapeItem offset, const Cell * ravel);
+   /// mux between Cell ravels and packed or typed ravels
+   const Cell & (*fetcher)(const Value & owner, ShapeItem offset);
 
    /// number of Value_P objects pointing to this value
    int owner_count;
@@ -932,6 +1057,9 @@ protected:
    /// The ravel of \b this value.
    Cell * ravel;
 
+   /// the search structures of \b this value (see get_search_cache())
+   mutable SearchCache * search_cache;
+
    /// the cells of a short (i.e. ⍴,value ≤ SHORT_VALUE_LENGTH_WANTED) value
    Cell short_value[SHORT_VALUE_LENGTH_WANTED];
 
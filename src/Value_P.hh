@@ -120,6 +120,15 @@ public:
    /// constructor: a packed array with shape \b sh
    inline Value_P(const Shape & sh, uint64_t * bits, const char * loc);
 
+   /// constructor: an integer array with shape \b sh and a typed ravel
+   inline Value_P(const Shape & sh, APL_Integer * ints, const char * loc);
+
+   /// constructor: a real array with shape \b sh and a typed ravel
+   inline Value_P(const Shape & sh, APL_Float * reals, const char * loc);
+
+   /// constructor: a character array with shape \b sh and a typed ravel
+   inline Value_P(const Shape & sh, Unicode * chars, const char * loc);
+
    /// a new vector value from a UCS string
    inline Value_P(const UCS_string & ucs, const char * loc);
 
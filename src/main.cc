@@ -400,8 +400,9 @@ const bool log_startup = uprefs.parse_argv_1() || log_startup0;
 
    uprefs.read_config_file(true,  log_startup);   // in /etc/gnu-apl.d/
    uprefs.read_config_file(false, log_startup);   // in $HOME/.config/gnu_apl/
-   uprefs.read_threshold_file(true,  log_startup);  // dito parallel_thresholds
-   uprefs.read_threshold_file(false, log_startup);  // dito parallel_thresholds
+   uprefs.read_threshold_file(true,  false, log_startup);  // dito
+   uprefs.read_threshold_file(false, false, log_startup);  // dito
+   uprefs.read_threshold_file(false, true,  log_startup);  // from ]PCAL SAVE
 
    // NOTE: struct sigaction differs between GNU/Linux and other systems,
    // which causes compile errors for direct curly bracket assignment on